@@ -187,6 +187,22 @@ if (NOT lodepng_POPULATED)
     FETCHCONTENT_UPDATES_DISCONNECTED_LODEPNG)
 endif ()
 
+# zlib
+FetchContent_Declare(zlib
+  URL "https://github.com/madler/zlib/releases/download/v1.3.1/zlib-1.3.1.tar.gz"
+  URL_HASH SHA256=9a93b2b7dfdac77ceba5a558a580e74667dd6fede4585b91eefb60f03b72df23)
+FetchContent_GetProperties(zlib)
+if (NOT zlib_POPULATED)
+  message(STATUS "Fetch zlib ...")
+  FetchContent_Populate(zlib)
+  file(COPY ${CMAKE_SOURCE_DIR}/libs/zlib/CMakeLists.txt DESTINATION ${zlib_SOURCE_DIR})
+  add_subdirectory(${zlib_SOURCE_DIR} ${zlib_BINARY_DIR} EXCLUDE_FROM_ALL)
+  set_target_properties(zlib PROPERTIES FOLDER libs)
+  mark_as_advanced(FORCE
+    FETCHCONTENT_SOURCE_DIR_ZLIB
+    FETCHCONTENT_UPDATES_DISCONNECTED_ZLIB)
+endif ()
+
 # datraw
 FetchContent_Declare(datraw
   URL "https://github.com/UniStuttgart-VISUS/datraw/archive/v1.0.9.tar.gz"
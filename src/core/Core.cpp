@@ -1,9 +1,13 @@
 #include "Core.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <regex>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
@@ -14,12 +18,14 @@
 #include <imgui_impl_opengl3.h>
 
 #include "PluginDescriptor.h"
+#include "PluginModuleLoader.h"
 #include "PluginRegister.h"
 #include "RenderPlugin.h"
 #include "util/FileUtil.h"
+#include "util/Framebuffer.h"
 #include "util/GLFWUtil.h"
 #include "util/GLUtil.h"
-#include "util/ImageUtil.h"
+#include "util/ImGuiUtil.h"
 
 using namespace OGL4Core2::Core;
 
@@ -29,15 +35,64 @@ static constexpr int openGLVersionMajor = 4;
 static constexpr int openGLVersionMinor = 5;
 static constexpr char imguiGlslVersion[] = "#version 450";
 static constexpr char title[] = "OGL4Core2";
+static constexpr char frameZoneName[] = "Frame";
+// ImGui needs a few frames to process input and to settle hover states and window layout.
+static constexpr int imguiSettleFrames = 3;
+// Without events, on-demand rendering still wakes up regularly, e.g., to blink the text cursor of ImGui.
+static constexpr double idleWaitTimeout = 0.5;
 
 Core::Core(Config cfg)
     : cfg_(std::move(cfg)),
       window_(nullptr),
       running_(false),
       frameNumber_(0),
+      time_(0.0),
+      deltaTime_(0.0),
+      windowTitle_{},
+      framePacer_(cfg_.pacingMode, cfg_.fpsCap),
+      swapInterval_(-1),
+      redrawRequested_(true),
+      redrawFrames_(0),
+      idle_(false),
+      gpuTimer_(nullptr),
+      benchmark_(nullptr),
+      benchmarkStartFrame_(1),
+      benchmarkFinished_(false),
+      pluginConstructionTime_(0.0),
+      firstFrameTime_(0.0),
+      sweepPos_(0),
+      profilerFrameBegin_(0),
+      profilerFrameEnd_(0),
+      profilerDroppedZones_(0),
+      profilerPaused_(false),
+      trace_(nullptr),
+      gpuToCpuOffset_(0),
+      traceSaveRequested_(false),
+      inputRecorder_(nullptr),
+      inputPlayer_(nullptr),
+      replayingInput_(false),
+      readback_(nullptr),
+      videoWriter_(nullptr),
+      tiledScreenshotRequested_(false),
+      tiledScreenshotSize_{7680, 4320},
+      defaultFramebuffer_(0),
+      defaultViewport_{0, 0, 0, 0},
+      tile_{0, 0, 0, 0, 0, 0},
+      pluginModules_(nullptr),
+      // Benchmarks measure the construction of each plugin.
+      pluginCache_(cfg_.benchmarkFrames > 0 ? 0 : cfg_.pluginCacheSize, cfg_.pluginCacheBudget),
+      textureCooker_(cfg_.textureCacheDir),
+      resourceCache_(textureCooker_, cfg_.resourceCacheBudget),
+      textureStreamer_(nullptr),
       currentPlugin_(nullptr),
+      loaderWindow_(nullptr),
+      mainThread_(std::this_thread::get_id()),
+      loadingProgress_(-1.0f),
       currentPluginIdx_(-1),
       pluginSelectionIdx_(0),
+      activeView_(0),
+      inputView_(0),
+      pressedMouseButtons_(0),
       windowWidth_(-1),
       windowHeight_(-1),
       framebufferWidth_(-1),
@@ -46,19 +101,21 @@ Core::Core(Config cfg)
       mouseX_(0.0),
       mouseY_(0.0),
       cameraControlMode_(AbstractCamera::MouseControlMode::None) {
-    Core::initGLFW();
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, openGLVersionMajor);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, openGLVersionMinor);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
-    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
-
-    window_ = glfwCreateWindow(initWindowSizeWidth, initWindowSizeHeight, title, nullptr, nullptr);
-    if (!window_) {
-        Core::terminateGLFW();
-        throw std::runtime_error("GLFW window creation failed!");
+    Profiler::setThreadName("Main");
+
+    const int initWidth = cfg_.windowWidth > 0 ? cfg_.windowWidth : initWindowSizeWidth;
+    const int initHeight = cfg_.windowHeight > 0 ? cfg_.windowHeight : initWindowSizeHeight;
+
+    if (cfg_.headless) {
+        window_ = createHeadlessWindow(initWidth, initHeight);
+    } else {
+        Core::initGLFW();
+        setWindowHints();
+        window_ = glfwCreateWindow(initWidth, initHeight, title, nullptr, nullptr);
+        if (!window_) {
+            Core::terminateGLFW();
+            throw std::runtime_error("GLFW window creation failed!");
+        }
     }
 
     glfwMakeContextCurrent(window_);
@@ -82,12 +139,63 @@ Core::Core(Config cfg)
     // ignore notifications
     glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
 
+    readback_ = std::make_unique<ReadbackRing>();
+    textureStreamer_ = std::make_unique<TextureStreamer>(textureCooker_, cfg_.textureUploadBudget);
+    gpuTimer_ = std::make_unique<GpuTimer>();
+    calibrateGpuClock();
+
+    // The last frames are always recorded, so a trace can be saved from the GUI at any time.
+    const std::filesystem::path traceFilename(cfg_.traceFilename);
+    const bool streamTrace = !traceFilename.empty() && traceFilename.extension() != ".json";
+    trace_ = std::make_unique<TraceRecorder>(cfg_.traceFrames, streamTrace ? traceFilename : std::filesystem::path());
+
+    // The hints of the main window are still set, so the context is compatible.
+    if (useAsyncPluginCreation()) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        loaderWindow_ = glfwCreateWindow(1, 1, title, nullptr, window_);
+        if (loaderWindow_ == nullptr) {
+            std::cerr << "Cannot create shared OpenGL context, plugins are constructed synchronously." << std::endl;
+        }
+    }
+
+    // Benchmark renders as fast as possible and measures the rendering of every frame.
+    if (cfg_.benchmarkFrames > 0) {
+        framePacer_.setMode(FramePacer::Mode::Uncapped);
+        cfg_.frameCaching = false;
+    }
+    if (GLFWmonitor* monitor = glfwGetPrimaryMonitor(); monitor != nullptr) {
+        if (const GLFWvidmode* mode = glfwGetVideoMode(monitor); mode != nullptr) {
+            framePacer_.setRefreshRate(mode->refreshRate);
+        }
+    }
+
     // The initial size above is only a hint for the window manager, but no guarantied window size. Further the window
     // size can be adjusted by DPI scaling on some systems. This initial resize will not be caught by the callback
     // events. Therefore, here do an initial size query.
     glfwGetWindowSize(window_, &windowWidth_, &windowHeight_);
     glfwGetFramebufferSize(window_, &framebufferWidth_, &framebufferHeight_);
 
+    // Mouse positions are recorded in window coordinates, so a different size changes the replayed interaction.
+    if (!cfg_.inputReplayFilename.empty()) {
+        inputPlayer_ = std::make_unique<InputPlayer>(cfg_.inputReplayFilename);
+        std::cout << "Replaying " << inputPlayer_->numEvents() << " input events \"" << cfg_.inputReplayFilename
+                  << "\"" << std::endl;
+        if (inputPlayer_->windowWidth() != windowWidth_ || inputPlayer_->windowHeight() != windowHeight_) {
+            std::cerr << "Input was recorded with window size " << inputPlayer_->windowWidth() << "x"
+                      << inputPlayer_->windowHeight() << ", but the window has size " << windowWidth_ << "x"
+                      << windowHeight_ << "!" << std::endl;
+        }
+    }
+    if (!cfg_.inputRecordFilename.empty()) {
+        inputRecorder_ = std::make_unique<InputRecorder>(cfg_.inputRecordFilename, windowWidth_, windowHeight_);
+    }
+
+    // Without a window, the plugin renders into an offscreen framebuffer of the same size.
+    if (cfg_.headless) {
+        headlessFramebuffer_ = std::make_unique<Framebuffer>(framebufferWidth_, framebufferHeight_);
+    }
+    resetDefaultFramebuffer();
+
     glfwSetWindowUserPointer(window_, this);
 
     glfwSetWindowRefreshCallback(window_, [](GLFWwindow* window) {
@@ -132,17 +240,14 @@ Core::Core(Config cfg)
 
     validateImGuiScale();
 
-    // Setup Plugins
+    // Setup Plugins, modules add their plugins to the ones compiled into the executable.
+    if (!cfg_.pluginModuleDir.empty()) {
+        pluginModules_ = std::make_unique<PluginModuleLoader>(cfg_.pluginModuleDir);
+    }
     if (PluginRegister::empty()) {
         throw std::runtime_error("No plugins found!");
     }
-    // Plugin names for ImGui combo box
-    for (const auto& pluginDescriptor : PluginRegister::getAll()) {
-        const auto& name = pluginDescriptor->name();
-        pluginNamesImGui_.insert(pluginNamesImGui_.end(), name.begin(), name.end());
-        pluginNamesImGui_.push_back('\0');
-    }
-    pluginNamesImGui_.push_back('\0');
+    updatePluginNames();
 
     // Plugins will be initialized on the fly in render method. No need to duplicate initialization here.
 
@@ -157,6 +262,30 @@ Core::Core(Config cfg)
         }
     }
 
+    // Compare plugins are initialized on the fly in render method, as the selected plugin.
+    for (const auto& name : cfg_.comparePluginNames) {
+        const int idx = PluginRegister::find(name);
+        if (idx < 0) {
+            throw std::runtime_error("Compare plugin \"" + name + "\" not found!");
+        }
+        addCompareView(idx);
+    }
+
+    // Plugins of the benchmark sweep, the default plugin is ignored.
+    if (cfg_.benchmarkSweep) {
+        const std::regex filter(cfg_.benchmarkSweepFilter);
+        const auto& plugins = PluginRegister::getAll();
+        for (std::size_t i = 0; i < plugins.size(); i++) {
+            if (std::regex_search(plugins[i]->name(), filter)) {
+                sweepPlugins_.push_back(static_cast<int>(i));
+            }
+        }
+        if (sweepPlugins_.empty()) {
+            throw std::runtime_error("No plugins match benchmark filter \"" + cfg_.benchmarkSweepFilter + "\"!");
+        }
+        pluginSelectionIdx_ = sweepPlugins_.front();
+    }
+
     // Sort and filter screenshot frame list
     if (!cfg_.screenshotFrames.empty()) {
         std::sort(cfg_.screenshotFrames.begin(), cfg_.screenshotFrames.end());
@@ -170,13 +299,37 @@ Core::Core(Config cfg)
 
 Core::~Core() {
     // Delete active plugin here, before destroying the OpenGL context.
+    // A plugin still being constructed is destroyed right away.
+    if (pendingPlugin_.valid()) {
+        try {
+            pendingPlugin_.get();
+        } catch (const std::exception&) {
+        }
+    }
     camera_.reset();
     currentPlugin_ = nullptr;
+    pluginCache_.clear();
+    views_.clear();
+    resourceCache_.clear();
+    textureStreamer_ = nullptr;
+    // Plugin code is gone after unloading the modules.
+    pluginModules_ = nullptr;
+
+    // Buffers of the readback ring and the offscreen framebuffer are owned by the OpenGL context.
+    readback_ = nullptr;
+    headlessFramebuffer_ = nullptr;
+    gpuTimer_ = nullptr;
+
+    // Wait for screenshots still being encoded in the background.
+    imageWriter_.flush();
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
+    if (loaderWindow_ != nullptr) {
+        glfwDestroyWindow(loaderWindow_);
+    }
     glfwDestroyWindow(window_);
     Core::terminateGLFW();
 }
@@ -187,19 +340,94 @@ void Core::run() {
     }
     running_ = true;
     while (!glfwWindowShouldClose(window_)) {
-        frameNumber_++;
-
-        if (fps_.tick()) {
-            std::string windowTitle = std::string(title) + " [ " + fps_.getFpsString() + " ]";
-            glfwSetWindowTitle(window_, windowTitle.c_str());
+        // Benchmark results must not mix plugin versions.
+        if (pluginModules_ != nullptr && cfg_.benchmarkFrames == 0) {
+            reloadPluginModules();
+        }
+        if (!isRedrawNeeded()) {
+            OGL4CORE2_PROFILE_ZONE("WaitEvents");
+            glfwWaitEventsTimeout(idleWaitTimeout);
+            // Keep the text cursor blinking.
+            if (ImGui::GetIO().WantTextInput) {
+                redrawRequested_ = true;
+            }
+            idle_ = true;
+            continue;
+        }
+        if (idle_) {
+            // The idle time is no frame time. The frame pacer does not need this, it never catches up on late frames.
+            idle_ = false;
+            frameStats_.restart();
+        }
+        if (framePacer_.swapInterval() != swapInterval_) {
+            swapInterval_ = framePacer_.swapInterval();
+            glfwSwapInterval(swapInterval_);
+        }
+        {
+            OGL4CORE2_PROFILE_ZONE("Frame pacing");
+            framePacer_.wait();
+            // Rendering late is about latency, so use the latest input.
+            if (framePacer_.mode() == FramePacer::Mode::RenderLate) {
+                glfwPollEvents();
+            }
         }
+        const auto frameStart = std::chrono::steady_clock::now();
+        const uint64_t traceFrameBegin = Profiler::now();
+        {
+            OGL4CORE2_PROFILE_ZONE(frameZoneName);
+            frameNumber_++;
+            updateClock();
+
+            if (frameStats_.tick()) {
+                std::snprintf(windowTitle_.data(), windowTitle_.size(), "%s [ %s ]", title, frameStats_.format());
+                glfwSetWindowTitle(window_, windowTitle_.data());
+            }
 
-        draw();
+            gpuTimer_->beginFrame(frameNumber_);
+            streamTextures();
+            draw();
+            gpuTimer_->endFrame();
 
-        screenshot();
+            capture();
 
-        glfwSwapBuffers(window_);
-        glfwPollEvents();
+            {
+                OGL4CORE2_PROFILE_ZONE("SwapBuffers");
+                framePacer_.beginSwap();
+                glfwSwapBuffers(window_);
+                framePacer_.endSwap();
+            }
+            {
+                OGL4CORE2_PROFILE_ZONE("PollEvents");
+                glfwPollEvents();
+            }
+            if (inputPlayer_ != nullptr) {
+                replayInput();
+            }
+
+            collectGpuTimes(false);
+        }
+        collectProfilerZones();
+        trace_->addFrame(frameNumber_, traceFrameBegin, Profiler::now());
+        if (traceSaveRequested_) {
+            traceSaveRequested_ = false;
+            saveTrace("trace." + std::to_string(frameNumber_) + ".json");
+        }
+        // The GPU clock may drift against the CPU clock.
+        if (frameNumber_ % 256 == 0) {
+            calibrateGpuClock();
+        }
+        if (cfg_.benchmarkFrames > 0) {
+            const std::chrono::duration<double, std::milli> cpuTime = std::chrono::steady_clock::now() - frameStart;
+            benchmarkFrame(cpuTime.count());
+        }
+    }
+    // Write screenshots and recorded frames which are still in flight.
+    finishCaptures();
+    // Report of a benchmark aborted by closing the window.
+    finishBenchmark();
+    finishBenchmarkSweep();
+    if (!cfg_.traceFilename.empty() && std::filesystem::path(cfg_.traceFilename).extension() == ".json") {
+        saveTrace(cfg_.traceFilename);
     }
     running_ = false;
 }
@@ -212,22 +440,80 @@ std::filesystem::path Core::getPluginResourcesPath() const {
 }
 
 bool Core::isKeyPressed(Key key) const {
+    if (inputPlayer_ != nullptr) {
+        return inputPlayer_->isKeyPressed(static_cast<int>(key));
+    }
     return glfwGetKey(window_, static_cast<int>(key)) == GLFW_PRESS;
 }
 
 bool Core::isMouseButtonPressed(MouseButton button) const {
+    if (inputPlayer_ != nullptr) {
+        return inputPlayer_->isMouseButtonPressed(static_cast<int>(button));
+    }
     return glfwGetMouseButton(window_, static_cast<int>(button)) == GLFW_PRESS;
 }
 
 void Core::getMousePos(double& xpos, double& ypos) const {
-    glfwGetCursorPos(window_, &xpos, &ypos);
+    if (inputPlayer_ != nullptr) {
+        inputPlayer_->getMousePos(xpos, ypos);
+    } else {
+        glfwGetCursorPos(window_, &xpos, &ypos);
+    }
     scaleWindowPosToFramebufferPos(xpos, ypos);
+    // Relative to the view of the plugin.
+    xpos -= viewX(activeView_);
 }
 
 void Core::setWindowSize(int width, int height) const {
+    requireMainThread("setWindowSize");
     glfwSetWindowSize(window_, width, height);
 }
 
+void Core::resetDefaultFramebuffer() {
+    defaultFramebuffer_ = headlessFramebuffer_ != nullptr ? headlessFramebuffer_->name() : 0;
+    defaultViewport_[0] = 0;
+    defaultViewport_[1] = 0;
+    defaultViewport_[2] = framebufferWidth_;
+    defaultViewport_[3] = framebufferHeight_;
+    tile_ = {0, 0, framebufferWidth_, framebufferHeight_, framebufferWidth_, framebufferHeight_};
+}
+
+void Core::bindDefaultFramebuffer() const {
+    requireMainThread("bindDefaultFramebuffer");
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer_);
+    glViewport(defaultViewport_[0], defaultViewport_[1], defaultViewport_[2], defaultViewport_[3]);
+}
+
+glm::mat4 Core::getTileProjection() const {
+    // Scales the NDC range of the tile to [-1, 1], in clip space, i.e., the translation is multiplied by w.
+    glm::mat4 m(1.0f);
+    const auto fullWidth = static_cast<float>(tile_.fullWidth);
+    const auto fullHeight = static_cast<float>(tile_.fullHeight);
+    const auto width = static_cast<float>(tile_.width);
+    const auto height = static_cast<float>(tile_.height);
+    m[0][0] = fullWidth / width;
+    m[1][1] = fullHeight / height;
+    m[3][0] = (fullWidth - 2.0f * static_cast<float>(tile_.x) - width) / width;
+    m[3][1] = (fullHeight - 2.0f * static_cast<float>(tile_.y) - height) / height;
+    return m;
+}
+
+GpuTimer::Scope Core::scopedGpuTimer(const std::string& name) const {
+    requireMainThread("scopedGpuTimer");
+    return gpuTimer_->scope(name);
+}
+
+void Core::requestRedraw() const {
+    redrawRequested_ = true;
+    glfwPostEmptyEvent();
+}
+
+void Core::setLoadingProgress(float progress, const std::string& status) const {
+    std::lock_guard<std::mutex> lock(loadingMutex_);
+    loadingProgress_ = progress;
+    loadingStatus_ = status;
+}
+
 void Core::registerCamera(const std::shared_ptr<AbstractCamera>& camera) const {
     camera_ = camera;
 }
@@ -268,7 +554,503 @@ void Core::validateImGuiScale() {
     }
 }
 
+void Core::updatePluginNames() {
+    // Plugin names for ImGui combo box
+    pluginNamesImGui_.clear();
+    for (const auto& pluginDescriptor : PluginRegister::getAll()) {
+        const auto& name = pluginDescriptor->name();
+        pluginNamesImGui_.insert(pluginNamesImGui_.end(), name.begin(), name.end());
+        pluginNamesImGui_.push_back('\0');
+    }
+    pluginNamesImGui_.push_back('\0');
+}
+
+void Core::setPluginResourcesPath(const std::string& pluginPath) {
+    // Get plugin resource dir. This is done here, that we can keep access to path const as plugins should only get a
+    // const reference to core. But as having a resource dir is optional for plugins, we want to show an exception
+    // only if a plugin tries to access the path. Therefore, catch the exception and cache it.
+    try {
+        currentPluginResourcesPath_ = FileUtil::findPluginResourcesPath(pluginPath);
+    } catch (const std::exception& ex) {
+        currentPluginResourcesPathException_ = ex;
+        currentPluginResourcesPath_.clear();
+    }
+}
+
+void Core::switchPlugin() {
+    // The old plugin must be suspended or destroyed before the new plugin is constructed or resumed. Otherwise, this
+    // could mess up OpenGL states.
+    const int numPlugins = static_cast<int>(PluginRegister::size());
+    if (currentPlugin_ != nullptr && currentPluginIdx_ >= 0 && currentPluginIdx_ < numPlugins) {
+        OGL4CORE2_PROFILE_ZONE("Plugin suspend");
+        currentPlugin_->suspend();
+        const std::size_t memoryUsage = currentPlugin_->memoryUsage();
+        pluginCache_.insert(
+            {PluginRegister::get(currentPluginIdx_)->name(), std::move(currentPlugin_), camera_, memoryUsage});
+    }
+    camera_.reset();
+    currentPlugin_ = nullptr;
+
+    currentPluginIdx_ = pluginSelectionIdx_;
+    const auto& plugin = PluginRegister::get(currentPluginIdx_);
+    setPluginResourcesPath(plugin->path());
+
+    PluginCache::Entry cached;
+    if (pluginCache_.take(plugin->name(), cached)) {
+        OGL4CORE2_PROFILE_ZONE("Plugin resume");
+        currentPlugin_ = std::move(cached.plugin);
+        camera_ = cached.camera;
+        currentPlugin_->resume();
+        // Plugin needs to know window size.
+        currentPlugin_->resize(viewWidth(0), framebufferHeight_);
+        return;
+    }
+
+    pluginError_.clear();
+    if (useAsyncPluginCreation() && loaderWindow_ != nullptr) {
+        setLoadingProgress(-1.0f);
+        pendingPluginStart_ = std::chrono::steady_clock::now();
+        pendingPluginName_ = plugin->name();
+        // The core state used by the constructor (resources path, camera) is not changed while constructing, plugin
+        // switches wait and events are not passed to any plugin.
+        pendingPlugin_ = std::async(std::launch::async, [this, plugin]() {
+            Profiler::setThreadName("Plugin loader");
+            OGL4CORE2_PROFILE_ZONE("Plugin create");
+            glfwMakeContextCurrent(loaderWindow_);
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDebugMessageCallback(GLUtil::OpenGLMessageCallback, nullptr);
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+            std::shared_ptr<RenderPlugin> instance;
+            try {
+                instance = plugin->create(*this);
+                // Objects must be complete before they are used by the main context.
+                glFinish();
+            } catch (...) {
+                glfwMakeContextCurrent(nullptr);
+                throw;
+            }
+            glfwMakeContextCurrent(nullptr);
+            return instance;
+        });
+        return;
+    }
+
+    OGL4CORE2_PROFILE_ZONE("Plugin create");
+    const auto constructionStart = std::chrono::steady_clock::now();
+    currentPlugin_ = plugin->create(*this);
+    currentPlugin_->initGL();
+    // Plugin needs to know window size.
+    currentPlugin_->resize(viewWidth(0), framebufferHeight_);
+    const std::chrono::duration<double, std::milli> constructionTime =
+        std::chrono::steady_clock::now() - constructionStart;
+    pluginConstructionTime_ = constructionTime.count();
+}
+
+bool Core::isAutomatedRun() const {
+    return cfg_.benchmarkFrames > 0 || cfg_.autoQuit || !cfg_.screenshotFrames.empty() || cfg_.recordLastFrame > 0 ||
+           !cfg_.inputReplayFilename.empty();
+}
+
+bool Core::useAsyncPluginCreation() const {
+    // Automated runs expect the plugin in the first frame. Compare views switch the core state used by the constructor.
+    return cfg_.asyncPluginCreation && !isAutomatedRun() && views_.size() < 2;
+}
+
+void Core::streamTextures() {
+    // Automated runs must render the same frames on every run, independent of the loading time.
+    if (!textureStreamer_->update(isAutomatedRun())) {
+        return;
+    }
+    // Cached frames still show the placeholder.
+    if (currentPlugin_ != nullptr) {
+        currentPlugin_->invalidateFrame();
+    }
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        if (views_[i].plugin != nullptr) {
+            views_[i].plugin->invalidateFrame();
+        }
+    }
+}
+
+void Core::finishPluginCreation() {
+    if (pendingPlugin_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    const std::chrono::duration<double, std::milli> constructionTime =
+        std::chrono::steady_clock::now() - pendingPluginStart_;
+    try {
+        currentPlugin_ = pendingPlugin_.get();
+        currentPlugin_->initGL();
+        // Plugin needs to know window size.
+        currentPlugin_->resize(viewWidth(0), framebufferHeight_);
+        pluginConstructionTime_ = constructionTime.count();
+    } catch (const std::exception& ex) {
+        camera_.reset();
+        currentPlugin_ = nullptr;
+        pluginError_ = pendingPluginName_ + ": " + ex.what();
+        std::cerr << "Plugin construction failed: " << pluginError_ << std::endl;
+    }
+    redrawRequested_ = true;
+}
+
+void Core::requireMainThread(const char* method) const {
+    if (std::this_thread::get_id() != mainThread_) {
+        throw std::logic_error(std::string("Core::") + method +
+                               "() must be called on the main thread, call it from RenderPlugin::initGL() instead of "
+                               "the constructor!");
+    }
+}
+
+void Core::drawLoadingOverlay() {
+    if (!pendingPlugin_.valid() && pluginError_.empty()) {
+        return;
+    }
+    const ImVec2 center(static_cast<float>(windowWidth_) * 0.5f, static_cast<float>(windowHeight_) * 0.5f);
+    ImGui::SetNextWindowPos(center, ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::Begin("Plugin", nullptr,
+        ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+            ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+    if (pendingPlugin_.valid()) {
+        float progress;
+        std::string status;
+        {
+            std::lock_guard<std::mutex> lock(loadingMutex_);
+            progress = loadingProgress_;
+            status = loadingStatus_;
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - pendingPluginStart_;
+        ImGui::Text("Loading %s ... %.1f s", pendingPluginName_.c_str(), elapsed.count());
+        if (progress >= 0.0f) {
+            ImGui::ProgressBar(std::min(progress, 1.0f), ImVec2(300.0f * contentScale_, 0.0f));
+        }
+        if (!status.empty()) {
+            ImGui::TextUnformatted(status.c_str());
+        }
+    } else {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Loading plugin failed!");
+        ImGui::TextUnformatted(pluginError_.c_str());
+        if (ImGui::Button("Dismiss")) {
+            pluginError_.clear();
+        }
+    }
+    ImGui::End();
+}
+
+void Core::reloadPluginModules() {
+    // The code of the plugin being constructed must not be unloaded.
+    if (pendingPlugin_.valid()) {
+        return;
+    }
+    const auto changed = pluginModules_->pollChanges();
+    if (changed.empty()) {
+        return;
+    }
+    OGL4CORE2_PROFILE_ZONE("Core::reloadPluginModules");
+    const int numPlugins = static_cast<int>(PluginRegister::size());
+    const std::string currentName = currentPluginIdx_ >= 0 && currentPluginIdx_ < numPlugins
+                                        ? PluginRegister::get(currentPluginIdx_)->name()
+                                        : std::string();
+    const std::string selectedName = pluginSelectionIdx_ >= 0 && pluginSelectionIdx_ < numPlugins
+                                         ? PluginRegister::get(pluginSelectionIdx_)->name()
+                                         : std::string();
+
+    // The plugin instance must be destroyed before its code is unloaded.
+    bool currentReloaded = false;
+    for (const auto module : changed) {
+        currentReloaded = currentReloaded || pluginModules_->contains(module, currentName);
+    }
+    if (currentReloaded) {
+        camera_.reset();
+        currentPlugin_ = nullptr;
+    }
+    // Compare plugins of changed modules are constructed again, the selections are kept by name.
+    const auto pluginName = [numPlugins](int idx) {
+        return idx >= 0 && idx < numPlugins ? PluginRegister::get(idx)->name() : std::string();
+    };
+    std::vector<std::string> compareNames;
+    std::vector<std::string> compareSelectedNames;
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        auto& view = views_[i];
+        compareNames.push_back(pluginName(view.pluginIdx));
+        compareSelectedNames.push_back(pluginName(view.selectionIdx));
+        for (const auto module : changed) {
+            if (pluginModules_->contains(module, compareNames.back())) {
+                view.camera.reset();
+                view.plugin = nullptr;
+                compareNames.back().clear();
+            }
+        }
+    }
+    std::vector<std::string> cachedNames;
+    for (const auto& entry : pluginCache_.entries()) {
+        cachedNames.push_back(entry.name);
+    }
+    for (const auto& name : cachedNames) {
+        for (const auto module : changed) {
+            if (pluginModules_->contains(module, name)) {
+                pluginCache_.evict(name);
+            }
+        }
+    }
+    // Profiler zone names may point into the unloaded code, pass the pending zones to the trace while the names are
+    // still valid.
+    collectProfilerZones();
+    profilerZones_.clear();
+    profilerCollected_.clear();
+    trace_->clearZoneNameCache();
+
+    for (const auto module : changed) {
+        try {
+            pluginModules_->reload(module);
+        } catch (const std::exception& ex) {
+            std::cerr << "Reloading plugin module failed: " << ex.what() << std::endl;
+        }
+    }
+
+    // Plugin indices changed, keep the selection by name. A reloaded plugin is constructed again in the next frame.
+    updatePluginNames();
+    const int selectedIdx = PluginRegister::find(selectedName);
+    pluginSelectionIdx_ = selectedIdx >= 0 ? selectedIdx : 0;
+    currentPluginIdx_ = currentReloaded ? -1 : PluginRegister::find(currentName);
+    if (currentPluginIdx_ < 0) {
+        camera_.reset();
+        currentPlugin_ = nullptr;
+    }
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        auto& view = views_[i];
+        const int viewSelectedIdx = PluginRegister::find(compareSelectedNames[i - 1]);
+        view.selectionIdx = viewSelectedIdx >= 0 ? viewSelectedIdx : 0;
+        view.pluginIdx = PluginRegister::find(compareNames[i - 1]);
+        if (view.pluginIdx < 0) {
+            view.camera.reset();
+            view.plugin = nullptr;
+        }
+    }
+    redrawRequested_ = true;
+}
+
+void Core::addCompareView(int pluginIdx) {
+    // The first view shows the selected plugin.
+    if (views_.empty()) {
+        views_.emplace_back();
+    }
+    views_.emplace_back();
+    views_.back().selectionIdx = pluginIdx;
+    resizePlugins();
+}
+
+void Core::removeCompareView(std::size_t view) {
+    if (view == 0 || view >= views_.size()) {
+        throw std::out_of_range("Invalid compare view!");
+    }
+    views_.erase(views_.begin() + static_cast<std::ptrdiff_t>(view));
+    // The remaining view is kept by updateFrameCache(), if still needed.
+    if (views_.size() == 1) {
+        views_.clear();
+    }
+    inputView_ = 0;
+    resizePlugins();
+}
+
+void Core::updateCompareViews() {
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        if (views_[i].pluginIdx == views_[i].selectionIdx) {
+            continue;
+        }
+        activateView(i);
+        camera_.reset();
+        currentPlugin_ = nullptr;
+        currentPluginIdx_ = views_[i].selectionIdx;
+        const auto& plugin = PluginRegister::get(currentPluginIdx_);
+        setPluginResourcesPath(plugin->path());
+        OGL4CORE2_PROFILE_ZONE("Plugin create");
+        // A failing compare plugin must not take down the selected plugin, it is retried on the next selection.
+        try {
+            currentPlugin_ = plugin->create(*this);
+            currentPlugin_->initGL();
+            currentPlugin_->resize(viewWidth(i), framebufferHeight_);
+        } catch (const std::exception& ex) {
+            camera_.reset();
+            currentPlugin_ = nullptr;
+            std::cerr << "Compare plugin construction failed: " << plugin->name() << ": " << ex.what() << std::endl;
+        }
+    }
+    activateView(0);
+}
+
+void Core::updateFrameCache() {
+    // Without comparison, only the selected plugin with frame caching renders into the framebuffer of a single view.
+    if (views_.size() > 1) {
+        return;
+    }
+    const bool cacheFrame = cfg_.frameCaching && currentPlugin_ != nullptr && currentPlugin_->isFrameCaching();
+    if (cacheFrame && views_.empty()) {
+        // Same size as the window, the plugin does not need to be resized.
+        views_.emplace_back();
+        views_.back().framebuffer =
+            std::make_unique<Framebuffer>(std::max(framebufferWidth_, 1), std::max(framebufferHeight_, 1));
+    } else if (!cacheFrame && !views_.empty()) {
+        views_.clear();
+    }
+}
+
+void Core::activateView(std::size_t view) {
+    if (view == activeView_) {
+        return;
+    }
+    const auto swapState = [this](PluginView& v) {
+        std::swap(currentPluginIdx_, v.pluginIdx);
+        std::swap(currentPlugin_, v.plugin);
+        std::swap(camera_, v.camera);
+        std::swap(currentPluginResourcesPath_, v.resourcesPath);
+        std::swap(currentPluginResourcesPathException_, v.resourcesPathException);
+    };
+    // Move the state of the active view back, then the state of the new view into the members.
+    swapState(views_[activeView_]);
+    swapState(views_[view]);
+    activeView_ = view;
+}
+
+void Core::resizePlugins() {
+    if (views_.empty()) {
+        if (currentPlugin_ != nullptr) {
+            currentPlugin_->resize(framebufferWidth_, framebufferHeight_);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < views_.size(); i++) {
+        // A minimized window has size 0, but framebuffers need at least one pixel.
+        auto& view = views_[i];
+        const int width = std::max(viewWidth(i), 1);
+        const int height = std::max(framebufferHeight_, 1);
+        if (view.framebuffer == nullptr) {
+            view.framebuffer = std::make_unique<Framebuffer>(width, height);
+        } else {
+            view.framebuffer->resize(width, height);
+        }
+        view.renderedPlugin = nullptr;
+        activateView(i);
+        if (currentPlugin_ != nullptr) {
+            currentPlugin_->resize(viewWidth(i), framebufferHeight_);
+        }
+    }
+    activateView(0);
+}
+
+void Core::renderViews() {
+    OGL4CORE2_PROFILE_ZONE("Core::renderViews");
+    for (std::size_t i = 0; i < views_.size(); i++) {
+        activateView(i);
+        auto& view = views_[i];
+        // The selected plugin uses the main window for its GUI, the compare plugins get an own window in their column.
+        if (i > 0) {
+            const float scale = static_cast<float>(windowWidth_) / static_cast<float>(framebufferWidth_);
+            const std::string name = (currentPlugin_ != nullptr ? PluginRegister::get(currentPluginIdx_)->name()
+                                                                : std::string("Compare")) +
+                                     "##View" + std::to_string(i);
+            ImGui::SetNextWindowPos(ImVec2(static_cast<float>(viewX(i)) * scale + 10.0f, 10.0f), ImGuiCond_Once);
+            ImGui::Begin(name.c_str(), nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+        }
+        if (currentPlugin_ == nullptr) {
+            view.renderedPlugin = nullptr;
+        } else {
+            currentPlugin_->renderGui();
+            // Invalidations during render() are kept for the next frame.
+            const bool invalid = currentPlugin_->frameInvalid_.exchange(false);
+            if (invalid || !cfg_.frameCaching || !currentPlugin_->isFrameCaching() ||
+                currentPlugin_->isContinuousRendering() || view.renderedPlugin != currentPlugin_.get()) {
+                OGL4CORE2_PROFILE_ZONE("Plugin render");
+                defaultFramebuffer_ = view.framebuffer->name();
+                defaultViewport_[0] = 0;
+                defaultViewport_[1] = 0;
+                defaultViewport_[2] = view.framebuffer->width();
+                defaultViewport_[3] = view.framebuffer->height();
+                tile_ = {0, 0, defaultViewport_[2], defaultViewport_[3], defaultViewport_[2], defaultViewport_[3]};
+                bindDefaultFramebuffer();
+                glClear(GL_COLOR_BUFFER_BIT);
+                currentPlugin_->render();
+                view.renderedPlugin = currentPlugin_.get();
+                view.renderedFrames++;
+            } else {
+                view.cachedFrames++;
+            }
+        }
+        if (i > 0) {
+            ImGui::End();
+        }
+    }
+    activateView(0);
+
+    OGL4CORE2_PROFILE_ZONE("Composite views");
+    resetDefaultFramebuffer();
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer_);
+    glClear(GL_COLOR_BUFFER_BIT);
+    for (std::size_t i = 0; i < views_.size(); i++) {
+        const auto& view = views_[i];
+        if (view.renderedPlugin == nullptr) {
+            continue;
+        }
+        const auto& fbo = *view.framebuffer;
+        glBlitNamedFramebuffer(fbo.name(), defaultFramebuffer_, 0, 0, fbo.width(), fbo.height(), viewX(i), 0,
+            viewX(i) + fbo.width(), fbo.height(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+}
+
+void Core::drawCompareGui() {
+    // The core state of the views must not change while a plugin constructor may use it.
+    if (pendingPlugin_.valid()) {
+        ImGui::TextUnformatted("Waiting for plugin construction ...");
+        return;
+    }
+    std::size_t removedView = 0;
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::Combo("##Plugin", &views_[i].selectionIdx, pluginNamesImGui_.data());
+        ImGui::SameLine();
+        if (ImGui::Button("Remove")) {
+            removedView = i;
+        }
+        ImGui::PopID();
+    }
+    if (ImGui::Button("Add view")) {
+        addCompareView(pluginSelectionIdx_);
+    }
+    for (std::size_t i = 0; i < views_.size(); i++) {
+        ImGui::Text("View %zu: %llu rendered, %llu cached", i,
+            static_cast<unsigned long long>(views_[i].renderedFrames),
+            static_cast<unsigned long long>(views_[i].cachedFrames));
+    }
+    if (removedView > 0) {
+        removeCompareView(removedView);
+    }
+}
+
+int Core::viewX(std::size_t view) const {
+    if (views_.empty()) {
+        return 0;
+    }
+    return framebufferWidth_ * static_cast<int>(view) / static_cast<int>(views_.size());
+}
+
+int Core::viewWidth(std::size_t view) const {
+    if (views_.empty()) {
+        return framebufferWidth_;
+    }
+    return viewX(view + 1) - viewX(view);
+}
+
+std::size_t Core::viewAt(double xpos) const {
+    for (std::size_t i = views_.size(); i > 1; i--) {
+        if (xpos >= static_cast<double>(viewX(i - 1))) {
+            return i - 1;
+        }
+    }
+    return 0;
+}
+
 void Core::draw() {
+    OGL4CORE2_PROFILE_ZONE("Core::draw");
     validateImGuiScale();
 
     ImGui_ImplOpenGL3_NewFrame();
@@ -282,97 +1064,668 @@ void Core::draw() {
 
     if (ImGui::CollapsingHeader("Plugins", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Combo("Plugin", &pluginSelectionIdx_, pluginNamesImGui_.data());
+        ImGui::Checkbox("Frame caching", &cfg_.frameCaching);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Reuse the last image of plugins with frame caching, while their frame is valid.");
+        }
+        if (!views_.empty()) {
+            ImGui::Text("Frames: %llu rendered, %llu cached", static_cast<unsigned long long>(views_[0].renderedFrames),
+                static_cast<unsigned long long>(views_[0].cachedFrames));
+        }
+        if (cfg_.benchmarkFrames == 0 && ImGui::TreeNode("Plugin cache")) {
+            int capacity = static_cast<int>(pluginCache_.capacity());
+            if (ImGui::InputInt("Instances", &capacity) && capacity >= 0) {
+                pluginCache_.setCapacity(static_cast<std::size_t>(capacity));
+            }
+            int budgetMb = static_cast<int>(pluginCache_.memoryBudget() / (1024 * 1024));
+            if (ImGui::InputInt("Budget (MiB)", &budgetMb, 64, 1024) && budgetMb >= 0) {
+                pluginCache_.setMemoryBudget(static_cast<std::size_t>(budgetMb) * 1024 * 1024);
+            }
+            ImGui::Text("%zu suspended, %.1f MiB, %zu hits / %zu misses", pluginCache_.size(),
+                static_cast<double>(pluginCache_.memoryUsage()) / (1024.0 * 1024.0), pluginCache_.hits(),
+                pluginCache_.misses());
+            for (const auto& entry : pluginCache_.entries()) {
+                ImGui::BulletText("%s (%.1f MiB)", entry.name.c_str(),
+                    static_cast<double>(entry.memoryUsage) / (1024.0 * 1024.0));
+            }
+            if (ImGui::Button("Clear")) {
+                pluginCache_.clear();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Resource cache")) {
+            int budgetMb = static_cast<int>(resourceCache_.memoryBudget() / (1024 * 1024));
+            if (ImGui::InputInt("Budget (MiB)", &budgetMb, 64, 1024) && budgetMb >= 0) {
+                resourceCache_.setMemoryBudget(static_cast<std::size_t>(budgetMb) * 1024 * 1024);
+            }
+            ImGui::Text("%zu resources, %.1f MiB, %zu hits / %zu misses", resourceCache_.size(),
+                static_cast<double>(resourceCache_.memoryUsage()) / (1024.0 * 1024.0), resourceCache_.hits(),
+                resourceCache_.misses());
+            if (!textureCooker_.directory().empty()) {
+                ImGui::Text("Cooked textures: %zu hits / %zu misses", textureCooker_.hits(), textureCooker_.misses());
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("%s", textureCooker_.directory().string().c_str());
+                }
+            }
+            if (ImGui::Button("Clear")) {
+                resourceCache_.clear();
+            }
+            ImGui::TreePop();
+        }
+    }
+    if (ImGui::CollapsingHeader("Compare")) {
+        drawCompareGui();
+    }
+    if (ImGui::CollapsingHeader("Frame Times")) {
+        ImGui::PlotLines("##FrameTimes", frameStats_.plotData(), frameStats_.plotCount(), frameStats_.plotOffset(),
+            frameStats_.format(), 0.0f, std::max(33.3f, static_cast<float>(frameStats_.max())),
+            ImVec2(ImGui::GetContentRegionAvail().x, 80.0f * contentScale_));
+        ImGui::Text("min %.2f / mean %.2f / max %.2f ms", frameStats_.min(), frameStats_.mean(), frameStats_.max());
+        ImGui::Text("p50 %.2f / p95 %.2f / p99 %.2f ms", frameStats_.percentile(50.0), frameStats_.percentile(95.0),
+            frameStats_.percentile(99.0));
+        ImGui::Text("Spikes (> 2x median): %llu", static_cast<unsigned long long>(frameStats_.spikeCount()));
+        if (ImGui::Button("Reset")) {
+            frameStats_.reset();
+        }
+    }
+    if (ImGui::CollapsingHeader("Frame Pacing")) {
+        auto mode = framePacer_.mode();
+        if (ImGuiUtil::EnumCombo("Mode", mode,
+                {{FramePacer::Mode::VSync, "VSync"}, {FramePacer::Mode::Uncapped, "Uncapped"},
+                    {FramePacer::Mode::Capped, "FPS cap"}, {FramePacer::Mode::RenderLate, "Render late"}})) {
+            framePacer_.setMode(mode);
+        }
+        if (mode == FramePacer::Mode::Capped) {
+            float fps = static_cast<float>(framePacer_.targetFps());
+            if (ImGui::InputFloat("FPS cap", &fps, 1.0f, 10.0f, "%.1f") && fps > 0.0f) {
+                framePacer_.setTargetFps(fps);
+            }
+        }
+        ImGui::Checkbox("On-demand rendering", &cfg_.onDemandRendering);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Only render after input, resize or a redraw request of the plugin.");
+        }
+        ImGui::Text("Jitter (std. dev.): %.3f ms", frameStats_.stddev());
+        ImGui::Text("Wait: %.3f ms, sleep overshoot: %.3f ms", framePacer_.lastWaitMs(),
+            framePacer_.sleepOvershootMs());
+        if (mode == FramePacer::Mode::RenderLate) {
+            ImGui::Text("Frame work estimate: %.3f ms", framePacer_.frameWorkEstimateMs());
+        }
+    }
+    if (ImGui::CollapsingHeader("GPU Timing")) {
+        ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(gpuTimes_.frameNumber), gpuTimes_.ms);
+        for (const auto& scope : gpuTimes_.scopes) {
+            ImGui::Text("%*s%s: %.3f ms", 2 * (scope.depth + 1), "", scope.name.c_str(), scope.ms);
+        }
+    }
+    if (ImGui::CollapsingHeader("CPU Profiler")) {
+        bool enabled = Profiler::isEnabled();
+        if (ImGui::Checkbox("Enabled", &enabled)) {
+            Profiler::setEnabled(enabled);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Pause", &profilerPaused_);
+        ImGui::SameLine();
+        if (ImGui::Button("Save trace")) {
+            traceSaveRequested_ = true;
+        }
+        ImGui::Text("Frame: %.3f ms, dropped zones: %llu",
+            static_cast<double>(profilerFrameEnd_ - profilerFrameBegin_) * 1.0e-6,
+            static_cast<unsigned long long>(profilerDroppedZones_));
+        drawProfilerTimeline();
+    }
+    if (ImGui::CollapsingHeader("Capture")) {
+        ImGui::InputInt2("Size", tiledScreenshotSize_);
+        if (ImGui::Button("Save high-res screenshot")) {
+            tiledScreenshotRequested_ = true;
+        }
+    }
+    // Plugins are switched only after a background construction is finished. All plugin modules may fail to load
+    // after a change.
+    if (pendingPlugin_.valid()) {
+        finishPluginCreation();
+    } else if (currentPluginIdx_ != pluginSelectionIdx_ && !PluginRegister::empty()) {
+        switchPlugin();
+    }
+    updateCompareViews();
+    updateFrameCache();
+    drawLoadingOverlay();
+
+    if (views_.empty()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer_);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        if (currentPlugin_ != nullptr) {
+            OGL4CORE2_PROFILE_ZONE("Plugin render");
+            currentPlugin_->renderGui();
+            currentPlugin_->render();
+        }
+    } else {
+        renderViews();
     }
-    if (currentPluginIdx_ != pluginSelectionIdx_) {
-        currentPluginIdx_ = pluginSelectionIdx_;
-        // Need to delete plugin first, so destructor of old plugin runs before constructor of new plugin.
-        // Otherwise, this could mess up OpenGL states.
-        currentPlugin_ = nullptr;
 
-        // Init new plugin
-        const auto& plugin = PluginRegister::get(currentPluginIdx_);
+    ImGui::End();
+    OGL4CORE2_PROFILE_ZONE("ImGui render");
+    ImGui::Render();
+    // Plugins may leave own framebuffers bound, GUI always goes into the default framebuffer.
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebuffer_);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
 
-        // Get plugin resource dir. This is done here, that we can keep access to path const as plugins should only
-        // get a const reference to core. But as having a resource dir is optional for plugins, we want to show an
-        // exception only if a plugin tries to access the path. Therefore, catch the exception and cache it.
-        try {
-            currentPluginResourcesPath_ = FileUtil::findPluginResourcesPath(plugin->path());
-        } catch (const std::exception& ex) {
-            currentPluginResourcesPathException_ = ex;
-            currentPluginResourcesPath_.clear();
+void Core::capture() {
+    OGL4CORE2_PROFILE_ZONE("Core::capture");
+    // Collect finished readbacks of previous frames without stalling.
+    ReadbackRing::Frame frame;
+    while (readback_->pop(frame)) {
+        processCapturedFrame(std::move(frame));
+    }
+
+    bool takeScreenshot = !cfg_.screenshotFrames.empty() && cfg_.screenshotFrames.front() == frameNumber_;
+    if (takeScreenshot) {
+        cfg_.screenshotFrames.erase(cfg_.screenshotFrames.begin());
+        const int width = cfg_.screenshotWidth > 0 ? cfg_.screenshotWidth : framebufferWidth_;
+        const int height = cfg_.screenshotHeight > 0 ? cfg_.screenshotHeight : framebufferHeight_;
+        if (width != framebufferWidth_ || height != framebufferHeight_) {
+            saveTiledScreenshot(screenshotFilename(frameNumber_), width, height);
+            takeScreenshot = false;
+        } else {
+            pendingScreenshots_.push_back(frameNumber_);
         }
+    }
+    if (tiledScreenshotRequested_) {
+        tiledScreenshotRequested_ = false;
+        saveTiledScreenshot(screenshotFilename(frameNumber_, "hires"), tiledScreenshotSize_[0],
+            tiledScreenshotSize_[1]);
+    }
 
-        currentPlugin_ = plugin->create(*this);
-        // Plugin needs to know window size.
-        currentPlugin_->resize(framebufferWidth_, framebufferHeight_);
+    if (takeScreenshot || isRecordingFrame(frameNumber_)) {
+        // All buffers are in flight, only now we need to wait for the oldest one.
+        if (readback_->full() && readback_->pop(frame, true)) {
+            processCapturedFrame(std::move(frame));
+        }
+        readback_->start(frameNumber_, framebufferWidth_, framebufferHeight_, defaultFramebuffer_);
     }
 
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (cfg_.autoQuit && cfg_.screenshotFrames.empty() && frameNumber_ >= cfg_.recordLastFrame &&
+        (cfg_.benchmarkFrames == 0 || benchmarkFinished_) && readback_->empty() &&
+        (inputPlayer_ == nullptr || inputPlayer_->finished())) {
+        glfwSetWindowShouldClose(window_, GLFW_TRUE);
+    }
+}
 
-    if (currentPlugin_ != nullptr) {
-        currentPlugin_->render();
+void Core::processCapturedFrame(ReadbackRing::Frame&& frame) {
+    // Record first, the screenshot takes ownership of the pixel data.
+    if (isRecordingFrame(frame.frameNumber)) {
+        recordFrame(frame);
     }
+    if (!pendingScreenshots_.empty() && pendingScreenshots_.front() == frame.frameNumber) {
+        pendingScreenshots_.pop_front();
+        saveScreenshot(std::move(frame));
+    }
+}
 
-    ImGui::End();
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+void Core::saveScreenshot(ReadbackRing::Frame&& frame) {
+    imageWriter_.savePngImage(screenshotFilename(frame.frameNumber), std::move(frame.pixels), frame.width,
+        frame.height, cfg_.pngCompressionLevel);
 }
 
-void Core::screenshot() {
-    if (cfg_.screenshotFrames.empty() || cfg_.screenshotFrames.front() != frameNumber_) {
+void Core::saveTiledScreenshot(const std::filesystem::path& filename, int width, int height) {
+    if (currentPlugin_ == nullptr) {
         return;
     }
+    OGL4CORE2_PROFILE_ZONE("Tiled screenshot");
+    // The image is rendered in tiles into an offscreen framebuffer of the tile size. Plugins supporting tiled rendering
+    // are resized to the tile size and apply the tile projection, see getTileProjection(). All other plugins are
+    // resized to the full size and the viewport covers the full image, but is shifted for each tile, so that only the
+    // part of the tile is rasterized into the framebuffer. This is limited by the maximum viewport size and breaks for
+    // plugins setting their own viewport. Tiles are processed in bands from top to bottom and each band is passed to
+    // the PNG encoder right away, so the full image is never held in memory.
+    constexpr int maxTileSize = 2048;
+    try {
+        if (width <= 0 || height <= 0) {
+            throw std::runtime_error("Invalid screenshot size " + std::to_string(width) + "x" +
+                                     std::to_string(height) + "!");
+        }
+        const int tileWidth = std::min(width, maxTileSize);
+        const int tileHeight = std::min(height, maxTileSize);
+        const bool tileProjection = currentPlugin_->isTiledRendering();
+        if (!tileProjection) {
+            GLint maxViewportDims[2];
+            GLfloat viewportBoundsRange[2];
+            glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewportDims);
+            glGetFloatv(GL_VIEWPORT_BOUNDS_RANGE, viewportBoundsRange);
+            if (width > maxViewportDims[0] || height > maxViewportDims[1] ||
+                static_cast<float>(-width) < viewportBoundsRange[0] ||
+                static_cast<float>(-height) < viewportBoundsRange[0]) {
+                throw std::runtime_error("Screenshot size " + std::to_string(width) + "x" + std::to_string(height) +
+                                         " exceeds the maximum viewport size " + std::to_string(maxViewportDims[0]) +
+                                         "x" + std::to_string(maxViewportDims[1]) +
+                                         ", the plugin does not support tiled rendering!");
+            }
+        }
+
+        Framebuffer fbo(tileWidth, tileHeight);
+        std::vector<unsigned char> band(static_cast<std::size_t>(width) * static_cast<std::size_t>(tileHeight) * 4);
+        PngWriter png(filename, width, height, cfg_.pngCompressionLevel);
+
+        defaultFramebuffer_ = fbo.name();
+        if (tileProjection) {
+            // The full size is already known within resize(), e.g., for the aspect ratio.
+            tile_ = {0, 0, tileWidth, tileHeight, width, height};
+            currentPlugin_->resize(tileWidth, tileHeight);
+            defaultViewport_[0] = 0;
+            defaultViewport_[1] = 0;
+            defaultViewport_[2] = tileWidth;
+            defaultViewport_[3] = tileHeight;
+        } else {
+            tile_ = {0, 0, width, height, width, height};
+            currentPlugin_->resize(width, height);
+            defaultViewport_[2] = width;
+            defaultViewport_[3] = height;
+        }
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_PACK_ROW_LENGTH, width);
+        for (int top = 0; top < height; top += tileHeight) {
+            const int bandHeight = std::min(tileHeight, height - top);
+            const int bandY = height - top - bandHeight;
+            for (int x = 0; x < width; x += tileWidth) {
+                if (tileProjection) {
+                    tile_ = {x, bandY, tileWidth, tileHeight, width, height};
+                } else {
+                    defaultViewport_[0] = -x;
+                    defaultViewport_[1] = -bandY;
+                }
+                renderPluginOffscreen();
+
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.name());
+                glReadBuffer(GL_COLOR_ATTACHMENT0);
+                glReadPixels(0, 0, std::min(tileWidth, width - x), bandHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+                    band.data() + static_cast<std::size_t>(x) * 4);
+            }
+            png.writeRows(ImageView(band.data(), width, bandHeight, true));
+        }
+        png.finish();
+        std::cout << "Saved " << width << "x" << height << " screenshot \"" << filename.string() << "\"" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Tiled screenshot failed: " << ex.what() << std::endl;
+    }
+
+    // Restore window as render target.
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    resetDefaultFramebuffer();
+    bindDefaultFramebuffer();
+    currentPlugin_->resize(viewWidth(0), framebufferHeight_);
+    currentPlugin_->invalidateFrame();
+}
+
+void Core::renderPluginOffscreen() {
+    // Plugins may use ImGui within render(), so an ImGui frame is required, but it is never drawn.
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+    ImGui::Begin(title);
 
-    cfg_.screenshotFrames.erase(cfg_.screenshotFrames.begin());
+    bindDefaultFramebuffer();
+    glClear(GL_COLOR_BUFFER_BIT);
+    currentPlugin_->render();
 
-    std::vector<unsigned char> image(framebufferWidth_ * framebufferHeight_ * 4);
-    glReadBuffer(GL_BACK);
-    glReadPixels(0, 0, framebufferWidth_, framebufferHeight_, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+    ImGui::End();
+    ImGui::EndFrame();
+}
 
+std::string Core::screenshotFilename(uint64_t frameNumber, const std::string& infix) const {
     std::string filename = cfg_.screenshotFilename.empty() ? "screenshot" : cfg_.screenshotFilename;
+    if (!infix.empty()) {
+        filename += "." + infix;
+    }
     std::stringstream ss;
-    ss << std::setw(5) << std::setfill('0') << frameNumber_;
+    ss << std::setw(5) << std::setfill('0') << frameNumber;
     filename += "." + ss.str() + ".png";
+    return filename;
+}
 
-    ImageUtil::savePngImage(filename, std::move(image), framebufferWidth_, framebufferHeight_);
+void Core::recordFrame(const ReadbackRing::Frame& frame) {
+    try {
+        if (videoWriter_ == nullptr) {
+            const std::string filename = cfg_.recordFilename.empty() ? "recording.raw" : cfg_.recordFilename;
+            const auto format = VideoWriter::formatFromFilename(filename);
+            const uint64_t numFrames = cfg_.recordLastFrame - frame.frameNumber + 1;
+            videoWriter_ = std::make_unique<VideoWriter>(filename, format, frame.width, frame.height, numFrames,
+                cfg_.recordFps);
+            std::cout << "Recording " << numFrames << " frames (" << frame.width << "x" << frame.height << ", "
+                      << (format == VideoWriter::Format::Y4M ? "Y4M" : "raw RGBA") << ") to \"" << filename << "\""
+                      << std::endl;
+        }
+        videoWriter_->writeFrame(frame.view());
+        if (frame.frameNumber >= cfg_.recordLastFrame) {
+            std::cout << "Recording finished, " << videoWriter_->framesWritten() << " frames written." << std::endl;
+            videoWriter_ = nullptr;
+        }
+    } catch (const std::exception& ex) {
+        // Do not abort the application, but stop recording.
+        std::cerr << "Recording failed: " << ex.what() << std::endl;
+        videoWriter_ = nullptr;
+        cfg_.recordFirstFrame = 0;
+        cfg_.recordLastFrame = 0;
+    }
+}
 
-    if (cfg_.autoQuit && cfg_.screenshotFrames.empty()) {
-        glfwSetWindowShouldClose(window_, GLFW_TRUE);
+void Core::finishCaptures() {
+    ReadbackRing::Frame frame;
+    while (readback_->pop(frame, true)) {
+        processCapturedFrame(std::move(frame));
     }
+    // Close an incomplete recording, i.e., when the window was closed before the last frame.
+    videoWriter_ = nullptr;
+}
+
+bool Core::isRecordingFrame(uint64_t frameNumber) const {
+    return cfg_.recordFirstFrame > 0 && frameNumber >= cfg_.recordFirstFrame && frameNumber <= cfg_.recordLastFrame;
+}
+
+bool Core::isRedrawNeeded() {
+    if (redrawRequested_.exchange(false)) {
+        redrawFrames_ = imguiSettleFrames;
+    }
+    if (redrawFrames_ > 0) {
+        redrawFrames_--;
+        return true;
+    }
+    if (!cfg_.onDemandRendering || currentPlugin_ == nullptr || currentPluginIdx_ != pluginSelectionIdx_ ||
+        currentPlugin_->isContinuousRendering() || ImGui::IsAnyItemActive()) {
+        return true;
+    }
+    for (std::size_t i = 1; i < views_.size(); i++) {
+        const auto& view = views_[i];
+        if (view.pluginIdx != view.selectionIdx || (view.plugin != nullptr && view.plugin->isContinuousRendering())) {
+            return true;
+        }
+    }
+    // Automated runs and captures rely on consecutive frames.
+    return cfg_.autoQuit || cfg_.benchmarkFrames > 0 || inputPlayer_ != nullptr || pendingPlugin_.valid() ||
+           !cfg_.screenshotFrames.empty() || frameNumber_ < cfg_.recordLastFrame || !readback_->empty() ||
+           textureStreamer_->busy();
+}
+
+void Core::updateClock() {
+    if (cfg_.benchmarkFrames > 0) {
+        // Simulated clock, also set as GLFW time, so ImGui and plugins using glfwGetTime() see the same time.
+        deltaTime_ = cfg_.benchmarkTimeStep;
+        time_ = static_cast<double>(frameNumber_ - benchmarkStartFrame_) * cfg_.benchmarkTimeStep;
+        glfwSetTime(time_);
+    } else {
+        const double now = glfwGetTime();
+        deltaTime_ = frameNumber_ > 1 ? now - time_ : 0.0;
+        time_ = now;
+    }
+}
+
+void Core::benchmarkFrame(double cpuTime) {
+    if (benchmarkFinished_) {
+        return;
+    }
+    // Frame index relative to the start of the plugin, the first frame includes the plugin construction.
+    const uint64_t frame = frameNumber_ - benchmarkStartFrame_;
+    if (frame == 0) {
+        firstFrameTime_ = cpuTime - pluginConstructionTime_;
+    }
+    if (frame < cfg_.benchmarkWarmupFrames) {
+        return;
+    }
+    if (benchmark_ == nullptr) {
+        BenchmarkReport::Info info;
+        info.pluginName = PluginRegister::get(currentPluginIdx_)->name();
+        info.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        info.width = framebufferWidth_;
+        info.height = framebufferHeight_;
+        info.warmupFrames = cfg_.benchmarkWarmupFrames;
+        info.frames = cfg_.benchmarkFrames;
+        info.timeStep = cfg_.benchmarkTimeStep;
+        info.constructionMs = pluginConstructionTime_;
+        info.firstFrameMs = firstFrameTime_;
+        benchmark_ = std::make_unique<BenchmarkReport>(std::move(info));
+    }
+    benchmark_->setCpuTime(frame - cfg_.benchmarkWarmupFrames, cpuTime);
+
+    if (frame + 1 >= static_cast<uint64_t>(cfg_.benchmarkWarmupFrames) + cfg_.benchmarkFrames) {
+        // GPU times are only available a few frames later, wait for the remaining ones.
+        collectGpuTimes(true);
+        finishBenchmark();
+        if (cfg_.benchmarkSweep && sweepPos_ + 1 < sweepPlugins_.size()) {
+            // Continue with the next plugin, which is constructed in the next frame.
+            sweepPos_++;
+            pluginSelectionIdx_ = sweepPlugins_[sweepPos_];
+            benchmarkStartFrame_ = frameNumber_ + 1;
+        } else {
+            finishBenchmarkSweep();
+            benchmarkFinished_ = true;
+            glfwSetWindowShouldClose(window_, GLFW_TRUE);
+        }
+    }
+}
+
+void Core::collectGpuTimes(bool wait) {
+    const uint64_t firstBenchmarkFrame = benchmarkStartFrame_ + cfg_.benchmarkWarmupFrames;
+    while (gpuTimer_->pop(gpuTimes_, wait)) {
+        trace_->addGpuFrame(gpuTimes_, gpuToCpuOffset_);
+        if (benchmark_ != nullptr && gpuTimes_.frameNumber >= firstBenchmarkFrame) {
+            const std::size_t frameIdx = gpuTimes_.frameNumber - firstBenchmarkFrame;
+            benchmark_->setGpuTime(frameIdx, gpuTimes_.ms);
+            for (const auto& scope : gpuTimes_.scopes) {
+                benchmark_->addGpuScopeTime(scope.name, frameIdx, scope.ms);
+            }
+        }
+    }
+}
+
+void Core::collectProfilerZones() {
+    profilerCollected_.clear();
+    profilerDroppedZones_ += Profiler::collect(profilerCollected_);
+    trace_->addCpuZones(profilerCollected_);
+    if (profilerPaused_) {
+        return;
+    }
+    profilerZones_.insert(profilerZones_.end(), profilerCollected_.begin(), profilerCollected_.end());
+
+    // The frame zone is the last zone of the main thread which is finished in this frame.
+    for (auto it = profilerCollected_.rbegin(); it != profilerCollected_.rend(); ++it) {
+        if (it->name == frameZoneName) {
+            profilerFrameBegin_ = it->begin;
+            profilerFrameEnd_ = it->end;
+            break;
+        }
+    }
+    // Zones of worker threads may end later, keep everything not ending before the displayed frame.
+    profilerZones_.erase(std::remove_if(profilerZones_.begin(), profilerZones_.end(),
+                             [this](const Profiler::Zone& zone) { return zone.end < profilerFrameBegin_; }),
+        profilerZones_.end());
+}
+
+void Core::drawProfilerTimeline() const {
+    if (profilerFrameEnd_ <= profilerFrameBegin_) {
+        return;
+    }
+    // Rows per thread, one row for each nesting level, threads ordered by first use (main thread first).
+    std::vector<std::pair<uint32_t, uint32_t>> threadRows; // threadIdx, number of rows
+    for (const auto& zone : profilerZones_) {
+        if (zone.begin > profilerFrameEnd_) {
+            continue;
+        }
+        auto it = std::find_if(threadRows.begin(), threadRows.end(),
+            [&zone](const auto& rows) { return rows.first == zone.threadIdx; });
+        if (it == threadRows.end()) {
+            threadRows.emplace_back(zone.threadIdx, 0);
+            it = std::prev(threadRows.end());
+        }
+        it->second = std::max(it->second, zone.depth + 1);
+    }
+    std::sort(threadRows.begin(), threadRows.end());
+
+    const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    const double frameLength = static_cast<double>(profilerFrameEnd_ - profilerFrameBegin_);
+    const auto toX = [&](uint64_t t) {
+        const uint64_t clamped = std::clamp(t, profilerFrameBegin_, profilerFrameEnd_);
+        const auto offset = static_cast<double>(clamped - profilerFrameBegin_);
+        return origin.x + static_cast<float>(offset / frameLength) * width;
+    };
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float y = origin.y;
+    for (const auto& [threadIdx, numRows] : threadRows) {
+        drawList->AddText(ImVec2(origin.x, y), IM_COL32(200, 200, 200, 255), Profiler::threadName(threadIdx).c_str());
+        y += rowHeight;
+        for (const auto& zone : profilerZones_) {
+            if (zone.threadIdx != threadIdx || zone.begin > profilerFrameEnd_) {
+                continue;
+            }
+            const ImVec2 min(toX(zone.begin), y + static_cast<float>(zone.depth) * rowHeight);
+            const ImVec2 max(std::max(toX(zone.end), min.x + 1.0f), min.y + rowHeight - 1.0f);
+            // Stable color per zone name.
+            uint32_t hash = 2166136261u;
+            for (const char* c = zone.name; *c != '\0'; c++) {
+                hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+            }
+            drawList->AddRectFilled(min, max,
+                IM_COL32(80 + (hash & 0x7f), 80 + ((hash >> 8) & 0x7f), 80 + ((hash >> 16) & 0x7f), 255));
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), zone.name);
+            drawList->PopClipRect();
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3f ms", zone.name, static_cast<double>(zone.end - zone.begin) * 1.0e-6);
+            }
+        }
+        y += static_cast<float>(numRows) * rowHeight;
+    }
+    ImGui::Dummy(ImVec2(width, y - origin.y));
+}
+
+void Core::calibrateGpuClock() {
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    gpuToCpuOffset_ = static_cast<int64_t>(Profiler::now()) - gpuTime;
+}
+
+void Core::saveTrace(const std::filesystem::path& filename) const {
+    try {
+        trace_->saveJson(filename);
+        std::cout << "Saved trace of " << trace_->numFrames() << " frames \"" << filename.string() << "\"" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Saving trace failed: " << ex.what() << std::endl;
+    }
+}
+
+void Core::finishBenchmark() {
+    if (benchmark_ == nullptr) {
+        return;
+    }
+    benchmark_->print(std::cout);
+    if (cfg_.benchmarkSweep) {
+        // Saved together with the other plugins.
+        sweepReports_.push_back(std::move(*benchmark_));
+        benchmark_ = nullptr;
+        return;
+    }
+    const std::string filename = cfg_.benchmarkFilename.empty() ? "benchmark.json" : cfg_.benchmarkFilename;
+    try {
+        benchmark_->save(filename);
+        std::cout << "Saved benchmark report \"" << filename << "\"" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Saving benchmark report failed: " << ex.what() << std::endl;
+    }
+    benchmark_ = nullptr;
+}
+
+void Core::finishBenchmarkSweep() {
+    if (sweepReports_.empty()) {
+        return;
+    }
+    std::cout << std::endl;
+    BenchmarkReport::printComparison(std::cout, sweepReports_);
+    const std::string filename = cfg_.benchmarkFilename.empty() ? "benchmark.json" : cfg_.benchmarkFilename;
+    try {
+        BenchmarkReport::saveComparison(filename, sweepReports_);
+        std::cout << "Saved benchmark report of " << sweepReports_.size() << " plugins \"" << filename << "\""
+                  << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Saving benchmark report failed: " << ex.what() << std::endl;
+    }
+    sweepReports_.clear();
 }
 
 void Core::windowSizeEvent(int width, int height) {
+    OGL4CORE2_PROFILE_ZONE("Core::windowSizeEvent");
+    redrawRequested_ = true;
     windowWidth_ = width;
     windowHeight_ = height;
 }
 
 void Core::framebufferSizeEvent(int width, int height) {
+    OGL4CORE2_PROFILE_ZONE("Core::framebufferSizeEvent");
+    redrawRequested_ = true;
     // Save size for init of new plugin.
     framebufferWidth_ = width;
     framebufferHeight_ = height;
-    if (currentPlugin_ != nullptr) {
-        currentPlugin_->resize(width, height);
+    if (headlessFramebuffer_ != nullptr) {
+        headlessFramebuffer_->resize(width, height);
     }
+    resetDefaultFramebuffer();
+    resizePlugins();
 }
 
-void Core::keyEvent(int key, [[maybe_unused]] int scancode, int action, int mods) {
+void Core::keyEvent(int key, int scancode, int action, int mods) {
+    OGL4CORE2_PROFILE_ZONE("Core::keyEvent");
+    if (!filterInputEvent(InputEvent::key(key, scancode, action, mods))) {
+        return;
+    }
+    redrawRequested_ = true;
     mods = GLFWUtil::fixKeyboardMods(mods, key, action);
-    if (!ImGui::GetIO().WantCaptureKeyboard && currentPlugin_ != nullptr) {
+    if (imguiWantsKeyboard()) {
+        return;
+    }
+    activateView(inputView_);
+    if (currentPlugin_ != nullptr) {
         currentPlugin_->keyboard(static_cast<Key>(key), static_cast<KeyAction>(action), Mods(mods));
     }
+    activateView(0);
 }
 
 void Core::charEvent(unsigned int codepoint) {
-    if (!ImGui::GetIO().WantTextInput && currentPlugin_ != nullptr) {
+    OGL4CORE2_PROFILE_ZONE("Core::charEvent");
+    if (!filterInputEvent(InputEvent::character(codepoint))) {
+        return;
+    }
+    redrawRequested_ = true;
+    if (!replayingInput_ && ImGui::GetIO().WantTextInput) {
+        return;
+    }
+    activateView(inputView_);
+    if (currentPlugin_ != nullptr) {
         currentPlugin_->charInput(codepoint);
     }
+    activateView(0);
 }
 
 void Core::mouseButtonEvent(int button, int action, int mods) {
+    OGL4CORE2_PROFILE_ZONE("Core::mouseButtonEvent");
+    if (!filterInputEvent(InputEvent::mouseButton(button, action, mods))) {
+        return;
+    }
+    redrawRequested_ = true;
     auto b = static_cast<MouseButton>(button);
     auto a = static_cast<MouseButtonAction>(action);
     Mods m(mods);
 
+    // The view under the cursor at the press keeps receiving mouse input until all buttons are released.
+    if (button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST) {
+        if (a == MouseButtonAction::Press) {
+            pressedMouseButtons_ |= 1 << button;
+        } else if (a == MouseButtonAction::Release) {
+            pressedMouseButtons_ &= ~(1 << button);
+        }
+    }
+
     cameraControlMode_ = AbstractCamera::MouseControlMode::None;
     if (a == MouseButtonAction::Press && m.none()) {
         if (b == MouseButton::Left) {
@@ -384,15 +1737,31 @@ void Core::mouseButtonEvent(int button, int action, int mods) {
         }
     }
 
-    if (!ImGui::GetIO().WantCaptureMouse && currentPlugin_ != nullptr) {
+    if (imguiWantsMouse()) {
+        return;
+    }
+    activateView(inputView_);
+    if (currentPlugin_ != nullptr) {
         currentPlugin_->mouseButton(b, a, m);
     }
+    activateView(0);
 }
 
 void Core::mouseMoveEvent(double xpos, double ypos) {
+    OGL4CORE2_PROFILE_ZONE("Core::mouseMoveEvent");
+    if (!filterInputEvent(InputEvent::mouseMove(xpos, ypos))) {
+        return;
+    }
+    redrawRequested_ = true;
     scaleWindowPosToFramebufferPos(xpos, ypos);
+    if (pressedMouseButtons_ == 0) {
+        inputView_ = viewAt(xpos);
+    }
 
-    if (!ImGui::GetIO().WantCaptureMouse && currentPlugin_ != nullptr) {
+    activateView(inputView_);
+    if (!imguiWantsMouse() && currentPlugin_ != nullptr) {
+        const double x = static_cast<double>(viewX(inputView_));
+        const double width = static_cast<double>(viewWidth(inputView_));
         // Check camera event in mouseButtonEvent for correct modifier state. Checking here just for current key status
         // with glfwGetKey will miss the state when the modifier key was pressed before the window gets the focus. The
         // reason for this is, that glfwGetKey only returns a cached state, while the modifiers parameter contains the
@@ -400,39 +1769,156 @@ void Core::mouseMoveEvent(double xpos, double ypos) {
         if (cameraControlMode_ != AbstractCamera::MouseControlMode::None) {
             auto camera = camera_.lock();
             if (camera) {
-                double oldX = 2.0 * mouseX_ / static_cast<double>(framebufferWidth_) - 1.0;
+                double oldX = 2.0 * (mouseX_ - x) / width - 1.0;
                 double oldY = 1.0 - 2.0 * mouseY_ / static_cast<double>(framebufferHeight_);
-                double newX = 2.0 * xpos / static_cast<double>(framebufferWidth_) - 1.0;
+                double newX = 2.0 * (xpos - x) / width - 1.0;
                 double newY = 1.0 - 2.0 * ypos / static_cast<double>(framebufferHeight_);
                 camera->mouseMoveControl(cameraControlMode_, oldX, oldY, newX, newY);
+                currentPlugin_->invalidateFrame();
             }
         }
 
-        currentPlugin_->mouseMove(xpos, ypos);
+        currentPlugin_->mouseMove(xpos - x, ypos);
     }
+    activateView(0);
     mouseX_ = xpos;
     mouseY_ = ypos;
 }
 
 void Core::mouseScrollEvent(double xoffset, double yoffset) {
-    if (!ImGui::GetIO().WantCaptureMouse && currentPlugin_ != nullptr) {
-        if (!GLFWUtil::anyModKeyPressed(window_)) {
+    OGL4CORE2_PROFILE_ZONE("Core::mouseScrollEvent");
+    if (!filterInputEvent(InputEvent::mouseScroll(xoffset, yoffset))) {
+        return;
+    }
+    redrawRequested_ = true;
+    if (imguiWantsMouse()) {
+        return;
+    }
+    activateView(inputView_);
+    if (currentPlugin_ != nullptr) {
+        const bool modKeyPressed =
+            inputPlayer_ != nullptr ? inputPlayer_->anyModKeyPressed() : GLFWUtil::anyModKeyPressed(window_);
+        if (!modKeyPressed) {
             auto camera = camera_.lock();
             if (camera) {
                 camera->mouseScrollControl(xoffset, yoffset);
+                currentPlugin_->invalidateFrame();
             }
         }
         currentPlugin_->mouseScroll(xoffset, yoffset);
     }
+    activateView(0);
+}
+
+bool Core::filterInputEvent(InputEvent event) {
+    // Live input would let the replay diverge.
+    if (inputPlayer_ != nullptr) {
+        return replayingInput_;
+    }
+    // Input used by the GUI is not recorded, GUI interaction is not replayed.
+    if (inputRecorder_ != nullptr) {
+        const auto& io = ImGui::GetIO();
+        bool captured = io.WantCaptureMouse;
+        if (event.type == InputEvent::Type::Key) {
+            captured = io.WantCaptureKeyboard;
+        } else if (event.type == InputEvent::Type::Char) {
+            captured = io.WantTextInput;
+        }
+        if (!captured) {
+            event.frameNumber = frameNumber_;
+            inputRecorder_->add(event);
+        }
+    }
+    return true;
+}
+
+void Core::replayInput() {
+    OGL4CORE2_PROFILE_ZONE("Core::replayInput");
+    replayingInput_ = true;
+    InputEvent event;
+    while (inputPlayer_->next(frameNumber_, event)) {
+        switch (event.type) {
+            case InputEvent::Type::Key:
+                keyEvent(event.code, event.scancode, event.action, event.mods);
+                break;
+            case InputEvent::Type::Char:
+                charEvent(static_cast<unsigned int>(event.code));
+                break;
+            case InputEvent::Type::MouseButton:
+                mouseButtonEvent(event.code, event.action, event.mods);
+                break;
+            case InputEvent::Type::MouseMove:
+                mouseMoveEvent(event.x, event.y);
+                break;
+            case InputEvent::Type::MouseScroll:
+                mouseScrollEvent(event.x, event.y);
+                break;
+        }
+        if (inputPlayer_->finished()) {
+            std::cout << "Input replay finished at frame " << frameNumber_ << "." << std::endl;
+        }
+    }
+    replayingInput_ = false;
+}
+
+bool Core::imguiWantsMouse() const {
+    // Replayed events were not used by the GUI when they were recorded.
+    return !replayingInput_ && ImGui::GetIO().WantCaptureMouse;
+}
+
+bool Core::imguiWantsKeyboard() const {
+    return !replayingInput_ && ImGui::GetIO().WantCaptureKeyboard;
+}
+
+GLFWwindow* Core::createHeadlessWindow(int width, int height) {
+    // Try context creation without any display server first, this works with Mesa (including llvmpipe) and drivers
+    // supporting EGL surfaceless. As last resort, use a hidden window, which still requires a display.
+    struct HeadlessMode {
+        const char* name;
+        int platform;
+        int contextApi;
+    };
+    static constexpr HeadlessMode modes[] = {
+        {"EGL surfaceless", GLFW_PLATFORM_NULL, GLFW_EGL_CONTEXT_API},
+        {"OSMesa", GLFW_PLATFORM_NULL, GLFW_OSMESA_CONTEXT_API},
+        {"hidden window", GLFW_ANY_PLATFORM, GLFW_NATIVE_CONTEXT_API},
+    };
+    for (const auto& mode : modes) {
+        try {
+            Core::initGLFW(mode.platform);
+        } catch (const std::exception&) {
+            continue;
+        }
+        setWindowHints();
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, mode.contextApi);
+        GLFWwindow* window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (window != nullptr) {
+            std::cout << "Headless mode: " << mode.name << std::endl;
+            return window;
+        }
+        Core::terminateGLFW();
+    }
+    throw std::runtime_error("Headless OpenGL context creation failed!");
+}
+
+void Core::setWindowHints() {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, openGLVersionMajor);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, openGLVersionMinor);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
 }
 
 int Core::glfwReferenceCounter_ = 0;
 
-void Core::initGLFW() {
+void Core::initGLFW(int platform) {
     if (Core::glfwReferenceCounter_ <= 0) {
         glfwSetErrorCallback([](int error_code, const char* description) {
             std::cerr << "GLFW Error (" << error_code << "): " << description << std::endl;
         });
+        glfwInitHint(GLFW_PLATFORM, platform);
         if (!glfwInit()) {
             throw std::runtime_error("GLFW init failed!");
         }
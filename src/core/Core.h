@@ -1,31 +1,88 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <exception>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // clang-format off
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 // clang-format on
+#include <glm/ext/matrix_float4x4.hpp>
 
 #include "Input.h"
+#include "PluginCache.h"
+#include "ResourceCache.h"
+#include "TextureStreamer.h"
 #include "camera/AbstractCamera.h"
-#include "util/FpsCounter.h"
+#include "util/BenchmarkReport.h"
+#include "util/FramePacer.h"
+#include "util/FrameStatistics.h"
+#include "util/Framebuffer.h"
+#include "util/GpuTimer.h"
+#include "util/ImageWriter.h"
+#include "util/InputLog.h"
+#include "util/PngWriter.h"
+#include "util/Profiler.h"
+#include "util/ReadbackRing.h"
+#include "util/TextureCooker.h"
+#include "util/TraceRecorder.h"
+#include "util/VideoWriter.h"
 
 namespace OGL4Core2::Core {
+    class PluginModuleLoader;
     class RenderPlugin;
 
     class Core {
     public:
         struct Config {
             std::string defaultPluginName;
+            std::vector<std::string> comparePluginNames; // Plugins rendered side by side with the selected plugin.
+            std::size_t pluginCacheSize = 0; // Number of suspended plugin instances kept for instant switching.
+            std::size_t pluginCacheBudget = 0; // Memory budget of the suspended plugins in bytes, 0 for no limit.
+            std::size_t resourceCacheBudget = 512 * 1024 * 1024; // Memory budget of shared resources, 0 for no limit.
+            std::size_t textureUploadBudget = 16 * 1024 * 1024; // Bytes of asynchronously loaded textures per frame.
+            // Textures cooked with mipmaps by the resource getters, empty disables the disk cache.
+            std::string textureCacheDir = TextureCooker::defaultDirectory().string();
+            bool asyncPluginCreation = false; // Construct plugins on a worker thread with a shared OpenGL context.
+            std::string pluginModuleDir; // Plugin modules loaded at startup and reloaded on change, empty disables.
             std::vector<uint32_t> screenshotFrames;
             std::string screenshotFilename;
+            int pngCompressionLevel = PngWriter::defaultLevel;
+            int screenshotWidth = 0; // Screenshot size, 0 uses framebuffer size. Other sizes are rendered in tiles.
+            int screenshotHeight = 0;
             bool autoQuit = false;
+            uint32_t recordFirstFrame = 0; // First and last frame (inclusive) of recording, 0 disables recording.
+            uint32_t recordLastFrame = 0;
+            std::string recordFilename;
+            int recordFps = 60;
+            int windowWidth = 0; // Initial window size, 0 uses default size.
+            int windowHeight = 0;
+            bool headless = false; // Render offscreen without a visible window.
+            FramePacer::Mode pacingMode = FramePacer::Mode::VSync;
+            double fpsCap = 60.0; // Frame rate of FramePacer::Mode::Capped.
+            bool onDemandRendering = false; // Only render frames after input, resize or a plugin request.
+            bool frameCaching = true; // Reuse the last image of plugins with valid frames, see RenderPlugin.
+            uint32_t benchmarkFrames = 0; // Number of measured frames, 0 disables benchmark mode.
+            uint32_t benchmarkWarmupFrames = 0; // Frames rendered before measuring.
+            std::string benchmarkFilename;
+            double benchmarkTimeStep = 1.0 / 60.0; // Simulated time per frame in benchmark mode.
+            bool benchmarkSweep = false; // Benchmark all plugins matching the filter one after another.
+            std::string benchmarkSweepFilter = ".*"; // Regex searched in plugin names.
+            std::string inputRecordFilename; // Records all input events for replay.
+            std::string inputReplayFilename; // Replays recorded input events instead of live input.
+            std::string traceFilename; // "*.json" saves the last frames on exit, other names stream binary events.
+            uint32_t traceFrames = 300; // Number of frames kept in memory for trace export.
         };
 
         explicit Core(Config cfg);
@@ -41,13 +98,114 @@ namespace OGL4Core2::Core {
 
         void setWindowSize(int width, int height) const;
 
+        // Binds the framebuffer the plugin should render to and sets the matching viewport. Usually this is the window
+        // framebuffer, but e.g. during tiled capture it is an offscreen framebuffer of the tile size. Use this instead
+        // of binding framebuffer 0 after rendering into own framebuffers.
+        void bindDefaultFramebuffer() const;
+
+        // Part of the image rendered by the current render() call, in pixels from the bottom left of the full image.
+        // Usually the full image, but during tiled capture the plugin is resized to the tile size and renders one tile
+        // per call, see RenderPlugin::setTiledRendering(). All tiles have the same size, so tiles at the right and top
+        // edge extend beyond the full image.
+        struct Tile {
+            int x;
+            int y;
+            int width;
+            int height;
+            int fullWidth;
+            int fullHeight;
+        };
+        [[nodiscard]] inline const Tile& getTile() const {
+            return tile_;
+        }
+        // Multiply the projection matrix from the left with this matrix, so that the current tile of the full image
+        // fills the viewport. Identity unless rendering tiles.
+        [[nodiscard]] glm::mat4 getTileProjection() const;
+
+        [[nodiscard]] inline bool isHeadless() const {
+            return cfg_.headless;
+        }
+
+        // Time in seconds at the start of the current frame and time since the previous frame. In benchmark mode the
+        // clock advances by a fixed step per frame, independent of the actual frame time, so animations driven by
+        // this clock render the same frames on every run.
+        [[nodiscard]] inline double getTime() const {
+            return time_;
+        }
+        [[nodiscard]] inline double getDeltaTime() const {
+            return deltaTime_;
+        }
+
+        // Measures the GPU time of the commands issued until the returned object is destroyed. Scopes can be nested,
+        // results are shown in the GUI and included in the benchmark report.
+        [[nodiscard]] GpuTimer::Scope scopedGpuTimer(const std::string& name) const;
+
+        // Renders a new frame in on-demand rendering mode, see RenderPlugin::requestRedraw(). Can be called from any
+        // thread, e.g., when data loaded in the background is ready.
+        void requestRedraw() const;
+
+        // Progress in range [0, 1] and status text shown while the plugin is constructed in the background, see
+        // Config::asyncPluginCreation. Can be called from the plugin constructor, a negative progress shows no bar.
+        void setLoadingProgress(float progress, const std::string& status = std::string()) const;
+
+        // Strings, images and textures loaded by the resource getters of RenderPlugin, shared between all plugins.
+        [[nodiscard]] inline ResourceCache& getResourceCache() const {
+            return resourceCache_;
+        }
+
+        // Loads textures in the background, see RenderPlugin::getTextureResourceAsync().
+        [[nodiscard]] inline TextureStreamer& getTextureStreamer() const {
+            return *textureStreamer_;
+        }
+
         void registerCamera(const std::shared_ptr<AbstractCamera>& camera) const;
         void removeCamera() const;
 
     private:
         void validateImGuiScale();
+        void updatePluginNames();
+        void setPluginResourcesPath(const std::string& pluginPath);
+        void switchPlugin();
+        void addCompareView(int pluginIdx);
+        void removeCompareView(std::size_t view);
+        void updateCompareViews();
+        void updateFrameCache();
+        void activateView(std::size_t view);
+        void resizePlugins();
+        void renderViews();
+        void drawCompareGui();
+        [[nodiscard]] int viewX(std::size_t view) const;
+        [[nodiscard]] int viewWidth(std::size_t view) const;
+        [[nodiscard]] std::size_t viewAt(double xpos) const;
+        [[nodiscard]] bool isAutomatedRun() const;
+        [[nodiscard]] bool useAsyncPluginCreation() const;
+        void streamTextures();
+        void finishPluginCreation();
+        // Throws for calls from the plugin loader thread, whose context does not share the objects used by the method.
+        void requireMainThread(const char* method) const;
+        void drawLoadingOverlay();
+        void reloadPluginModules();
         void draw();
-        void screenshot();
+        void capture();
+        void processCapturedFrame(ReadbackRing::Frame&& frame);
+        void saveScreenshot(ReadbackRing::Frame&& frame);
+        void saveTiledScreenshot(const std::filesystem::path& filename, int width, int height);
+        void renderPluginOffscreen();
+        void resetDefaultFramebuffer();
+        [[nodiscard]] std::string screenshotFilename(uint64_t frameNumber, const std::string& infix = "") const;
+        void recordFrame(const ReadbackRing::Frame& frame);
+        void finishCaptures();
+        [[nodiscard]] bool isRecordingFrame(uint64_t frameNumber) const;
+        [[nodiscard]] bool isRedrawNeeded();
+        void updateClock();
+        void benchmarkFrame(double cpuTime);
+        void collectGpuTimes(bool wait);
+        void collectProfilerZones();
+        void drawProfilerTimeline() const;
+        void calibrateGpuClock();
+        void saveTrace(const std::filesystem::path& filename) const;
+        void finishBenchmark();
+        void finishBenchmarkSweep();
 
         void windowSizeEvent(int width, int height);
         void framebufferSizeEvent(int width, int height);
@@ -56,6 +214,10 @@ namespace OGL4Core2::Core {
         void mouseButtonEvent(int button, int action, int mods);
         void mouseMoveEvent(double xpos, double ypos);
         void mouseScrollEvent(double xoffset, double yoffset);
+        [[nodiscard]] bool filterInputEvent(InputEvent event);
+        void replayInput();
+        [[nodiscard]] bool imguiWantsMouse() const;
+        [[nodiscard]] bool imguiWantsKeyboard() const;
 
         void scaleWindowPosToFramebufferPos(double& xpos, double& ypos) const;
 
@@ -65,16 +227,102 @@ namespace OGL4Core2::Core {
         bool running_;
 
         uint64_t frameNumber_;
+        double time_;
+        double deltaTime_;
+
+        FrameStatistics frameStats_;
+        std::array<char, 128> windowTitle_;
+        FramePacer framePacer_;
+        int swapInterval_; // Currently applied, -1 if not set yet.
+        mutable std::atomic<bool> redrawRequested_;
+        int redrawFrames_; // Remaining frames to render in on-demand mode.
+        bool idle_; // Waited for events since the last frame.
+
+        std::unique_ptr<GpuTimer> gpuTimer_;
+        GpuTimer::Frame gpuTimes_; // Latest collected results.
+        std::unique_ptr<BenchmarkReport> benchmark_;
+        uint64_t benchmarkStartFrame_; // First frame of the benchmarked plugin.
+        bool benchmarkFinished_;
+        double pluginConstructionTime_; // Milliseconds, of the current plugin.
+        double firstFrameTime_;
+        std::vector<int> sweepPlugins_;
+        std::size_t sweepPos_;
+        std::vector<BenchmarkReport> sweepReports_;
+
+        // CPU profiler zones overlapping the last complete frame and the ones after it.
+        std::vector<Profiler::Zone> profilerZones_;
+        std::vector<Profiler::Zone> profilerCollected_;
+        uint64_t profilerFrameBegin_;
+        uint64_t profilerFrameEnd_;
+        uint64_t profilerDroppedZones_;
+        bool profilerPaused_;
+
+        std::unique_ptr<TraceRecorder> trace_;
+        int64_t gpuToCpuOffset_; // Profiler time minus GPU time in nanoseconds.
+        bool traceSaveRequested_;
 
-        FpsCounter fps_;
+        std::unique_ptr<InputRecorder> inputRecorder_;
+        std::unique_ptr<InputPlayer> inputPlayer_;
+        bool replayingInput_; // Replayed events are passed to the event methods, live events are dropped.
 
+        std::unique_ptr<ReadbackRing> readback_;
+        ImageWriter imageWriter_;
+        std::deque<uint64_t> pendingScreenshots_;
+        std::unique_ptr<VideoWriter> videoWriter_;
+        bool tiledScreenshotRequested_;
+        int tiledScreenshotSize_[2];
+
+        // Target of plugin rendering, see bindDefaultFramebuffer().
+        GLuint defaultFramebuffer_;
+        GLint defaultViewport_[4];
+        Tile tile_;
+        std::unique_ptr<Framebuffer> headlessFramebuffer_;
+
+        std::unique_ptr<PluginModuleLoader> pluginModules_;
+        PluginCache pluginCache_;
+        TextureCooker textureCooker_;
+        mutable ResourceCache resourceCache_;
+        std::unique_ptr<TextureStreamer> textureStreamer_;
         std::shared_ptr<RenderPlugin> currentPlugin_;
+        // Plugin construction in the background, using the context of a hidden window shared with the main window.
+        GLFWwindow* loaderWindow_;
+        std::thread::id mainThread_; // Owns the main context, container objects and queries are not shared with it.
+        std::future<std::shared_ptr<RenderPlugin>> pendingPlugin_;
+        std::chrono::steady_clock::time_point pendingPluginStart_;
+        std::string pendingPluginName_;
+        std::string pluginError_; // Exception of the last failed background construction.
+        mutable std::mutex loadingMutex_;
+        mutable float loadingProgress_;
+        mutable std::string loadingStatus_;
         std::filesystem::path currentPluginResourcesPath_;
         std::exception currentPluginResourcesPathException_;
         int currentPluginIdx_;
         int pluginSelectionIdx_;
         std::vector<char> pluginNamesImGui_;
 
+        // Side-by-side comparison, the window is split into columns. The first view shows the selected plugin, the
+        // others the compare plugins. Each plugin renders into an own framebuffer, which is copied into its column
+        // and reused while the frame of a plugin with frame caching is valid. Without comparison, a single view is
+        // used for a selected plugin with frame caching. The plugin of the active view is held by the current plugin
+        // members (index, instance, camera, resources path), so all methods used by plugins refer to it. The members
+        // of an active view hold no state, the first view is active outside of rendering and event handling.
+        struct PluginView {
+            int pluginIdx = -1;
+            int selectionIdx = 0;
+            std::shared_ptr<RenderPlugin> plugin;
+            std::weak_ptr<AbstractCamera> camera;
+            std::filesystem::path resourcesPath;
+            std::exception resourcesPathException;
+            std::unique_ptr<Framebuffer> framebuffer;
+            const RenderPlugin* renderedPlugin = nullptr; // Plugin of the image in the framebuffer.
+            uint64_t renderedFrames = 0;
+            uint64_t cachedFrames = 0;
+        };
+        std::vector<PluginView> views_; // Empty if the selected plugin renders directly into the window.
+        std::size_t activeView_;
+        std::size_t inputView_; // View receiving input, kept while a mouse button is pressed.
+        int pressedMouseButtons_;
+
         // Only for Win32 and X11 systems window size to framebuffer size is 1:1, according to GLFW doc. Within this
         // application we want to ignore high DPI scaling - at least for now - and handle only one size within the
         // plugins as main coordinate system. Because we are targeting OpenGL development, we use the framebuffer size
@@ -91,7 +339,9 @@ namespace OGL4Core2::Core {
         AbstractCamera::MouseControlMode cameraControlMode_;
         mutable std::weak_ptr<AbstractCamera> camera_;
 
-        static void initGLFW();
+        static GLFWwindow* createHeadlessWindow(int width, int height);
+        static void setWindowHints();
+        static void initGLFW(int platform = GLFW_ANY_PLATFORM);
         static void terminateGLFW();
 
         static int glfwReferenceCounter_;
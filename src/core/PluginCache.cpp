@@ -0,0 +1,69 @@
+#include "PluginCache.h"
+
+#include <utility>
+
+#include "RenderPlugin.h"
+
+using namespace OGL4Core2::Core;
+
+PluginCache::PluginCache(std::size_t capacity, std::size_t memoryBudget)
+    : capacity_(capacity),
+      memoryBudget_(memoryBudget),
+      memoryUsage_(0),
+      hits_(0),
+      misses_(0) {}
+
+void PluginCache::insert(Entry entry) {
+    // A plugin has at most one instance.
+    evict(entry.name);
+    memoryUsage_ += entry.memoryUsage;
+    entries_.push_front(std::move(entry));
+    shrink();
+}
+
+bool PluginCache::take(const std::string& name, Entry& entry) {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->name == name) {
+            memoryUsage_ -= it->memoryUsage;
+            entry = std::move(*it);
+            entries_.erase(it);
+            hits_++;
+            return true;
+        }
+    }
+    misses_++;
+    return false;
+}
+
+void PluginCache::evict(const std::string& name) {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->name == name) {
+            memoryUsage_ -= it->memoryUsage;
+            entries_.erase(it);
+            return;
+        }
+    }
+}
+
+void PluginCache::clear() {
+    entries_.clear();
+    memoryUsage_ = 0;
+}
+
+void PluginCache::setCapacity(std::size_t capacity) {
+    capacity_ = capacity;
+    shrink();
+}
+
+void PluginCache::setMemoryBudget(std::size_t memoryBudget) {
+    memoryBudget_ = memoryBudget;
+    shrink();
+}
+
+void PluginCache::shrink() {
+    while (!entries_.empty() &&
+           (entries_.size() > capacity_ || (memoryBudget_ > 0 && memoryUsage_ > memoryBudget_))) {
+        memoryUsage_ -= entries_.back().memoryUsage;
+        entries_.pop_back();
+    }
+}
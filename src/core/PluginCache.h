@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "camera/AbstractCamera.h"
+
+namespace OGL4Core2::Core {
+    class RenderPlugin;
+
+    /**
+     * Suspended plugin instances, kept alive for instant switching between plugins. Entries are ordered by last use,
+     * the least recently used instances are destroyed when the number of instances or their memory usage (as reported
+     * by RenderPlugin::memoryUsage()) exceed the limits. Suspending and resuming the instances is up to the caller.
+     */
+    class PluginCache {
+    public:
+        struct Entry {
+            std::string name;
+            std::shared_ptr<RenderPlugin> plugin;
+            std::weak_ptr<AbstractCamera> camera; // Camera registered by the plugin.
+            std::size_t memoryUsage = 0;
+        };
+
+        /**
+         * @param capacity Maximum number of instances, 0 disables the cache.
+         * @param memoryBudget Maximum memory usage of all instances in bytes, 0 for no limit.
+         */
+        explicit PluginCache(std::size_t capacity = 0, std::size_t memoryBudget = 0);
+        ~PluginCache() = default;
+
+        PluginCache(const PluginCache&) = delete;
+        PluginCache(PluginCache&&) = delete;
+        PluginCache& operator=(const PluginCache&) = delete;
+        PluginCache& operator=(PluginCache&&) = delete;
+
+        /**
+         * Add a suspended instance as most recently used entry. Least recently used entries, possibly including the
+         * new one, are destroyed to stay within the limits.
+         *
+         * @param entry
+         */
+        void insert(Entry entry);
+
+        /**
+         * Remove the instance of the plugin from the cache.
+         *
+         * @param name
+         * @param entry Output, the caller resumes the plugin.
+         * @return False if there is no cached instance.
+         */
+        bool take(const std::string& name, Entry& entry);
+
+        /**
+         * Destroy the cached instance of the plugin, if there is one.
+         *
+         * @param name
+         */
+        void evict(const std::string& name);
+
+        void clear();
+
+        void setCapacity(std::size_t capacity);
+        void setMemoryBudget(std::size_t memoryBudget);
+
+        [[nodiscard]] inline std::size_t capacity() const {
+            return capacity_;
+        }
+        [[nodiscard]] inline std::size_t memoryBudget() const {
+            return memoryBudget_;
+        }
+        [[nodiscard]] inline std::size_t size() const {
+            return entries_.size();
+        }
+        [[nodiscard]] inline std::size_t memoryUsage() const {
+            return memoryUsage_;
+        }
+        [[nodiscard]] inline std::size_t hits() const {
+            return hits_;
+        }
+        [[nodiscard]] inline std::size_t misses() const {
+            return misses_;
+        }
+
+        /**
+         * Names and memory usage of the cached instances, most recently used first.
+         */
+        [[nodiscard]] inline const std::list<Entry>& entries() const {
+            return entries_;
+        }
+
+    private:
+        void shrink();
+
+        std::size_t capacity_;
+        std::size_t memoryBudget_;
+        std::list<Entry> entries_; // Most recently used first.
+        std::size_t memoryUsage_;
+        std::size_t hits_;
+        std::size_t misses_;
+    };
+} // namespace OGL4Core2::Core
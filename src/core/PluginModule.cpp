@@ -0,0 +1,11 @@
+// Entry point of plugin modules. This file is part of the core sources, but only compiled into the plugin modules.
+#ifdef OGL4CORE2_PLUGIN_MODULE
+
+#include "PluginModule.h"
+
+extern "C" OGL4CORE2_PLUGIN_MODULE_EXPORT const OGL4Core2::Core::PluginDescriptorList*
+ogl4core2PluginModuleDescriptors() {
+    return &OGL4Core2::Core::PluginModule::descriptors();
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PluginDescriptor.h"
+
+#ifdef _WIN32
+#define OGL4CORE2_PLUGIN_MODULE_EXPORT __declspec(dllexport)
+#else
+#define OGL4CORE2_PLUGIN_MODULE_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace OGL4Core2::Core {
+    using PluginDescriptorList = std::vector<std::shared_ptr<AbstractPluginDescriptor>>;
+
+    // Signature and name of the function exported by each plugin module, returning the plugins of the module.
+    using PluginModuleEntry = const PluginDescriptorList* (*)();
+    static constexpr char pluginModuleEntryName[] = "ogl4core2PluginModuleDescriptors";
+
+    /**
+     * Plugin registration within a plugin module, i.e., a plugin directory built as shared library with the CMake
+     * option OGL4CORE2_PLUGIN_MODULES. The REGISTERPLUGIN macro adds the plugins to this module local list instead of
+     * the PluginRegister of the executable. After loading the module, the Core queries the list with the exported
+     * entry function (see PluginModule.cpp) and adds the plugins to the PluginRegister itself. Therefore, the Core
+     * knows which plugins to remove before the module is unloaded.
+     */
+    class PluginModule {
+    public:
+        PluginModule() = delete;
+        ~PluginModule() = delete;
+        PluginModule(const PluginModule&) = delete;
+        PluginModule(PluginModule&&) = delete;
+        PluginModule& operator=(const PluginModule) = delete;
+        PluginModule& operator=(PluginModule&&) = delete;
+
+        template<class C>
+        static bool add(const std::string& path, int idx = 1000) {
+            descriptors_.emplace_back(std::make_shared<PluginDescriptor<C>>(C::name(), path, idx));
+            return true;
+        }
+
+        [[nodiscard]] static inline const PluginDescriptorList& descriptors() {
+            return descriptors_;
+        }
+
+    private:
+        static inline PluginDescriptorList descriptors_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,199 @@
+#include "PluginModuleLoader.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <random>
+#else
+#include <cstdlib>
+#endif
+
+#include "PluginRegister.h"
+
+using namespace OGL4Core2::Core;
+
+#ifdef _WIN32
+static constexpr char moduleExtension[] = ".dll";
+#else
+static constexpr char moduleExtension[] = ".so";
+#endif
+static constexpr double pollInterval = 0.5; // Seconds.
+
+PluginModuleLoader::PluginModuleLoader(std::filesystem::path directory)
+    : directory_(std::move(directory)),
+      numLoads_(0),
+      lastPoll_(std::chrono::steady_clock::now()) {
+    if (!std::filesystem::is_directory(directory_)) {
+        throw std::runtime_error("Plugin module directory \"" + directory_.string() + "\" does not exist!");
+    }
+    // Private copies per process, multiple instances of the application may run at the same time. The libraries are
+    // loaded from this directory, so it must be newly created and only be writable by the current user, otherwise
+    // another user could replace a copy before it is loaded.
+    copyDirectory_ = createPrivateDirectory(std::filesystem::temp_directory_path() / "OGL4Core2-modules-");
+
+    scanDirectory();
+    for (auto& module : modules_) {
+        module.pending = fileState(module.path);
+        try {
+            load(module);
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+        }
+    }
+}
+
+PluginModuleLoader::~PluginModuleLoader() {
+    for (auto& module : modules_) {
+        unload(module);
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(copyDirectory_, ec);
+}
+
+std::vector<std::size_t> PluginModuleLoader::pollChanges() {
+    std::vector<std::size_t> changed;
+    const auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - lastPoll_).count() < pollInterval) {
+        return changed;
+    }
+    lastPoll_ = now;
+
+    scanDirectory();
+    for (std::size_t i = 0; i < modules_.size(); i++) {
+        auto& module = modules_[i];
+        const FileState state = fileState(module.path);
+        // Deleted files keep the loaded version, the file is usually only missing while being rebuilt.
+        if (state.size == 0) {
+            continue;
+        }
+        if (state != module.loaded && state == module.pending) {
+            changed.push_back(i);
+        }
+        module.pending = state;
+    }
+    return changed;
+}
+
+void PluginModuleLoader::reload(std::size_t module) {
+    if (module >= modules_.size()) {
+        throw std::out_of_range("Invalid plugin module index!");
+    }
+    unload(modules_[module]);
+    load(modules_[module]);
+}
+
+bool PluginModuleLoader::contains(std::size_t module, const std::string& pluginName) const {
+    if (module >= modules_.size()) {
+        return false;
+    }
+    for (const auto& descriptor : modules_[module].descriptors) {
+        if (descriptor->name() == pluginName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::filesystem::path PluginModuleLoader::modulePath(std::size_t module) const {
+    if (module >= modules_.size()) {
+        throw std::out_of_range("Invalid plugin module index!");
+    }
+    return modules_[module].path;
+}
+
+void PluginModuleLoader::scanDirectory() {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != moduleExtension) {
+            continue;
+        }
+        bool known = false;
+        for (const auto& module : modules_) {
+            known = known || module.path == entry.path();
+        }
+        if (!known) {
+            Module module;
+            module.path = entry.path();
+            modules_.push_back(std::move(module));
+        }
+    }
+}
+
+void PluginModuleLoader::load(Module& module) {
+    // Remember the version also if loading fails, to not retry until the file changes again.
+    module.loaded = fileState(module.path);
+    const std::string copyName =
+        module.path.stem().string() + "." + std::to_string(numLoads_++) + module.path.extension().string();
+    module.copyPath = copyDirectory_ / copyName;
+    std::filesystem::copy_file(module.path, module.copyPath, std::filesystem::copy_options::overwrite_existing);
+
+    module.library = std::make_unique<SharedLibrary>(module.copyPath);
+    const auto entry = module.library->function<PluginModuleEntry>(pluginModuleEntryName);
+    if (entry == nullptr) {
+        unload(module);
+        throw std::runtime_error("\"" + module.path.string() + "\" is no plugin module!");
+    }
+    module.descriptors = *entry();
+    for (const auto& descriptor : module.descriptors) {
+        if (PluginRegister::find(descriptor->name()) >= 0) {
+            unload(module);
+            throw std::runtime_error("Plugin \"" + descriptor->name() + "\" of \"" + module.path.string() +
+                                     "\" is already registered!");
+        }
+    }
+    for (const auto& descriptor : module.descriptors) {
+        PluginRegister::add(descriptor);
+    }
+    std::cout << "Loaded plugin module \"" << module.path.string() << "\" (" << module.descriptors.size()
+              << " plugins)" << std::endl;
+}
+
+void PluginModuleLoader::unload(Module& module) {
+    // The descriptors are objects of the library, they must be released before unloading it.
+    for (const auto& descriptor : module.descriptors) {
+        PluginRegister::remove(descriptor);
+    }
+    module.descriptors.clear();
+    module.library = nullptr;
+    if (!module.copyPath.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(module.copyPath, ec);
+        module.copyPath.clear();
+    }
+}
+
+std::filesystem::path PluginModuleLoader::createPrivateDirectory(const std::filesystem::path& prefix) {
+#ifdef _WIN32
+    // The temporary directory is per user on Windows, a new directory with a random name is not shared.
+    std::random_device random;
+    for (int attempt = 0; attempt < 16; attempt++) {
+        const std::filesystem::path directory = prefix.string() + std::to_string(random());
+        std::error_code ec;
+        // Returns false if the directory already exists.
+        if (std::filesystem::create_directory(directory, ec)) {
+            return directory;
+        }
+    }
+#else
+    // mkdtemp() creates a new directory with a unique name and mode 0700, it never reuses an existing directory.
+    std::string pattern = prefix.string() + "XXXXXX";
+    if (mkdtemp(pattern.data()) != nullptr) {
+        return pattern;
+    }
+#endif
+    throw std::runtime_error("Cannot create private plugin module directory \"" + prefix.string() + "*\"!");
+}
+
+PluginModuleLoader::FileState PluginModuleLoader::fileState(const std::filesystem::path& path) {
+    std::error_code ec;
+    FileState state;
+    state.writeTime = std::filesystem::last_write_time(path, ec);
+    state.size = ec ? 0 : std::filesystem::file_size(path, ec);
+    if (ec) {
+        return {};
+    }
+    return state;
+}
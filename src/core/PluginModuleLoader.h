@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PluginModule.h"
+#include "util/SharedLibrary.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Loads the plugin modules of a directory and adds their plugins to the PluginRegister. The module files are
+     * watched, changed or new modules are reported by pollChanges() and can then be reloaded without restarting the
+     * application. Each module is loaded from a private copy of the file, so the build can overwrite the original
+     * file while it is loaded, and a new version is never confused with the old one by the dynamic loader.
+     */
+    class PluginModuleLoader {
+    public:
+        /**
+         * Load all modules of the directory. Modules which fail to load are reported, but do not prevent loading the
+         * others.
+         *
+         * @param directory
+         */
+        explicit PluginModuleLoader(std::filesystem::path directory);
+        ~PluginModuleLoader();
+
+        PluginModuleLoader(const PluginModuleLoader&) = delete;
+        PluginModuleLoader(PluginModuleLoader&&) = delete;
+        PluginModuleLoader& operator=(const PluginModuleLoader&) = delete;
+        PluginModuleLoader& operator=(PluginModuleLoader&&) = delete;
+
+        /**
+         * Check the module files for changes, at most once per poll interval. A changed file is only reported when it
+         * did not change anymore since the previous poll, i.e., the linker has finished writing it.
+         *
+         * @return Indices of changed or new modules.
+         */
+        std::vector<std::size_t> pollChanges();
+
+        /**
+         * Unload the module, if loaded, and load the current version of the file. All plugin instances created by the
+         * module must be destroyed before. If loading fails, an exception is thrown and the module stays unloaded.
+         *
+         * @param module
+         */
+        void reload(std::size_t module);
+
+        /**
+         * @param module
+         * @param pluginName
+         * @return True if the plugin is provided by the module.
+         */
+        [[nodiscard]] bool contains(std::size_t module, const std::string& pluginName) const;
+
+        [[nodiscard]] inline std::size_t numModules() const {
+            return modules_.size();
+        }
+        [[nodiscard]] std::filesystem::path modulePath(std::size_t module) const;
+
+    private:
+        struct FileState {
+            std::filesystem::file_time_type writeTime{};
+            std::uintmax_t size = 0;
+
+            bool operator==(const FileState& other) const {
+                return writeTime == other.writeTime && size == other.size;
+            }
+            bool operator!=(const FileState& other) const {
+                return !(*this == other);
+            }
+        };
+
+        struct Module {
+            std::filesystem::path path;
+            FileState loaded;  // Version of the loaded library.
+            FileState pending; // Version seen at the previous poll.
+            std::filesystem::path copyPath;
+            std::unique_ptr<SharedLibrary> library;
+            PluginDescriptorList descriptors;
+        };
+
+        void scanDirectory();
+        void load(Module& module);
+        void unload(Module& module);
+        static FileState fileState(const std::filesystem::path& path);
+        /**
+         * Create a new directory only accessible by the current user, named prefix and a unique suffix. Fails instead
+         * of using an existing directory.
+         *
+         * @param prefix
+         * @return Path of the created directory.
+         */
+        static std::filesystem::path createPrivateDirectory(const std::filesystem::path& prefix);
+
+        std::filesystem::path directory_;
+        std::filesystem::path copyDirectory_;
+        std::vector<Module> modules_;
+        uint64_t numLoads_;
+        std::chrono::steady_clock::time_point lastPoll_;
+    };
+} // namespace OGL4Core2::Core
@@ -5,12 +5,19 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "PluginDescriptor.h"
 
+#ifdef OGL4CORE2_PLUGIN_MODULE
+#include "PluginModule.h"
+#define REGISTERPLUGIN(classname, idx) \
+    [[maybe_unused]] static inline bool is_registered_ = Core::PluginModule::add<classname>(PLUGIN_DIR, idx);
+#else
 #define REGISTERPLUGIN(classname, idx) \
     [[maybe_unused]] static inline bool is_registered_ = Core::PluginRegister::add<classname>(PLUGIN_DIR, idx);
+#endif
 
 namespace OGL4Core2::Core {
     class AbstractPluginDescriptor;
@@ -30,12 +37,30 @@ namespace OGL4Core2::Core {
             // directory with Linux style path separation `/`. It will later be used to load resources from the plugin
             // directory. Each plugin source file has PLUGIN_DIR defined from CMake to get this path. It is also
             // automatically used when using the REGISTERPLUGIN macro above.
-            plugins_.emplace_back(std::make_shared<PluginDescriptor<C>>(C::name(), path, idx));
-            std::sort(plugins_.begin(), plugins_.end(),
-                [](const auto& a, const auto& b) -> bool { return a->idx() < b->idx(); });
+            add(std::make_shared<PluginDescriptor<C>>(C::name(), path, idx));
             return true;
         }
 
+        static void add(std::shared_ptr<AbstractPluginDescriptor> descriptor) {
+            plugins_.emplace_back(std::move(descriptor));
+            std::stable_sort(plugins_.begin(), plugins_.end(),
+                [](const auto& a, const auto& b) -> bool { return a->idx() < b->idx(); });
+        }
+
+        static void remove(const std::shared_ptr<AbstractPluginDescriptor>& descriptor) {
+            plugins_.erase(std::remove(plugins_.begin(), plugins_.end(), descriptor), plugins_.end());
+        }
+
+        // Index of the plugin with the given name, -1 if not found.
+        [[nodiscard]] static int find(const std::string& name) {
+            for (std::size_t i = 0; i < plugins_.size(); i++) {
+                if (plugins_[i]->name() == name) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
         [[nodiscard]] static std::shared_ptr<AbstractPluginDescriptor> get(std::size_t i) {
             if (i >= plugins_.size()) {
                 throw std::out_of_range("Invalid plugin index!");
@@ -1,20 +1,22 @@
 #include "RenderPlugin.h"
 
 #include <algorithm>
-#include <fstream>
 #include <regex>
-#include <sstream>
 #include <stdexcept>
 #include <utility>
 
-#include <glad/gl.h>
-
 #include "Core.h"
-#include "util/ImageUtil.h"
 
 using namespace OGL4Core2::Core;
 
-RenderPlugin::RenderPlugin(const Core& c) : core_(c) {}
+RenderPlugin::RenderPlugin(const Core& c)
+    : core_(c),
+      continuousRendering_(false),
+      frameCaching_(false),
+      tiledRendering_(false),
+      frameInvalid_(true) {}
+
+void RenderPlugin::initGL() {}
 
 void RenderPlugin::resize([[maybe_unused]] int width, [[maybe_unused]] int height) {}
 
@@ -29,6 +31,38 @@ void RenderPlugin::mouseMove([[maybe_unused]] double xpos, [[maybe_unused]] doub
 
 void RenderPlugin::mouseScroll([[maybe_unused]] double xoffset, [[maybe_unused]] double yoffset) {}
 
+void RenderPlugin::suspend() {}
+
+void RenderPlugin::resume() {}
+
+std::size_t RenderPlugin::memoryUsage() const {
+    return 0;
+}
+
+void RenderPlugin::requestRedraw() const {
+    core_.requestRedraw();
+}
+
+void RenderPlugin::setContinuousRendering(bool continuous) {
+    if (continuous && !continuousRendering_) {
+        // Wake up the render loop if it is waiting for events.
+        core_.requestRedraw();
+    }
+    continuousRendering_ = continuous;
+}
+
+void RenderPlugin::renderGui() {}
+
+void RenderPlugin::invalidateFrame() {
+    frameInvalid_ = true;
+    core_.requestRedraw();
+}
+
+void RenderPlugin::setFrameCaching(bool caching) {
+    frameCaching_ = caching;
+    invalidateFrame();
+}
+
 std::filesystem::path RenderPlugin::getResourcePath(const std::string& name) const {
     auto basePath = core_.getPluginResourcesPath();
 
@@ -58,32 +92,50 @@ std::filesystem::path RenderPlugin::getResourceDirPath(const std::string& name)
 }
 
 std::string RenderPlugin::getStringResource(const std::string& name) const {
-    std::filesystem::path path = getResourceFilePath(name);
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot read resource file \"" + path.string() + "\"!");
-    }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    return *getSharedStringResource(name);
+}
+
+std::shared_ptr<const std::string> RenderPlugin::getSharedStringResource(const std::string& name) const {
+    return core_.getResourceCache().getString(getResourceFilePath(name));
+}
+
+Image RenderPlugin::getPngResource(const std::string& name) const {
+    return *getSharedPngResource(name);
+}
+
+std::shared_ptr<const Image> RenderPlugin::getSharedPngResource(const std::string& name) const {
+    return core_.getResourceCache().getImage(getResourceFilePath(name));
 }
 
 std::vector<unsigned char> RenderPlugin::getPngResource(const std::string& name, int& width, int& height) const {
-    return ImageUtil::loadPngImage(getResourceFilePath(name), width, height);
+    const auto image = getSharedPngResource(name);
+    const ImageView view = image->view();
+    width = view.width;
+    height = view.height;
+    // Copy the rows of the cached image in OpenGL row order (bottom-up).
+    std::vector<unsigned char> pixels(view.rowSize() * static_cast<std::size_t>(view.height));
+    for (int y = 0; y < view.height; y++) {
+        std::copy_n(view.rowFromBottom(y), view.rowSize(),
+            pixels.data() + static_cast<std::size_t>(y) * view.rowSize());
+    }
+    return pixels;
 }
 
 std::shared_ptr<glowl::Texture2D> RenderPlugin::getTextureResource(const std::string& name) const {
-    int width, height;
-    std::vector<unsigned char> image = getPngResource(name, width, height);
-    glowl::TextureLayout layout(GL_RGBA8, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, 1,
-        {
-            {GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE},
-            {GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE},
-            {GL_TEXTURE_MIN_FILTER, GL_LINEAR},
-            {GL_TEXTURE_MAG_FILTER, GL_LINEAR},
-        },
-        {});
-    return std::make_shared<glowl::Texture2D>(name, layout, image.data());
+    return core_.getResourceCache().getTexture(getResourceFilePath(name));
+}
+
+std::shared_ptr<AsyncTexture> RenderPlugin::getTextureResourceAsync(const std::string& name) const {
+    const std::filesystem::path path = getResourceFilePath(name);
+    ResourceCache& cache = core_.getResourceCache();
+    if (auto texture = cache.findTexture(path)) {
+        return std::make_shared<AsyncTexture>(std::move(texture), true);
+    }
+    // Captures the cache of the Core, not the plugin, which may be destroyed before the texture is ready.
+    return core_.getTextureStreamer().load(path,
+        [&cache, path](const std::shared_ptr<glowl::Texture2D>& texture, std::size_t memoryUsage) {
+            cache.insertTexture(path, texture, memoryUsage);
+        });
 }
 
 std::vector<std::filesystem::path> RenderPlugin::getResourceDirFilePaths(const std::string& name,
@@ -104,3 +156,20 @@ std::vector<std::filesystem::path> RenderPlugin::getResourceDirFilePaths(const s
     std::sort(files.begin(), files.end());
     return files;
 }
+
+std::shared_ptr<glowl::Texture2DArray> RenderPlugin::getTextureArrayResource(const std::string& name,
+    const std::string& filter) const {
+    return TextureArrayLoader::loadTextureArray(name, getResourceDirFilePaths(name, filter), loadingProgress(name));
+}
+
+std::shared_ptr<glowl::Texture3D> RenderPlugin::getTexture3DResource(const std::string& name,
+    const std::string& filter) const {
+    return TextureArrayLoader::loadTexture3D(name, getResourceDirFilePaths(name, filter), loadingProgress(name));
+}
+
+TextureArrayLoader::ProgressCallback RenderPlugin::loadingProgress(const std::string& name) const {
+    return [this, name](std::size_t loaded, std::size_t total) {
+        core_.setLoadingProgress(static_cast<float>(loaded) / static_cast<float>(total),
+            "Loading " + name + " (" + std::to_string(loaded) + "/" + std::to_string(total) + ")");
+    };
+}
@@ -1,13 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <glowl/Texture2D.hpp>
+#include <glowl/Texture2DArray.hpp>
+#include <glowl/Texture3D.hpp>
 
 #include "Input.h"
+#include "TextureArrayLoader.h"
+#include "TextureStreamer.h"
+#include "util/Image.h"
 
 namespace OGL4Core2::Core {
     class Core;
@@ -19,6 +26,13 @@ namespace OGL4Core2::Core {
 
         virtual void render() = 0;
 
+        // Called once on the main thread after the constructor returned, before the first resize(). With asynchronous
+        // plugin construction the constructor runs on a worker thread with an own context sharing only textures,
+        // buffers, shaders and samplers with the main context. Container objects (vertex array objects, framebuffers,
+        // program pipelines, transform feedbacks), query objects and Core methods using the main context, i.e.,
+        // bindDefaultFramebuffer() and scopedGpuTimer(), belong here.
+        virtual void initGL();
+
         virtual void resize(int width, int height);
         virtual void keyboard(Key key, KeyAction action, Mods mods);
         virtual void charInput(unsigned int codepoint);
@@ -26,16 +40,88 @@ namespace OGL4Core2::Core {
         virtual void mouseMove(double xpos, double ypos);
         virtual void mouseScroll(double xoffset, double yoffset);
 
+        // With the plugin cache enabled, switching to another plugin suspends this plugin instead of destroying it.
+        // A suspended plugin is not rendered and receives no events, it may release transient GPU memory (e.g.,
+        // framebuffers), which is recreated on resume. The size may have changed in between, resize() is called after
+        // resume(). memoryUsage() is the approximate memory in bytes (GPU and CPU) kept while suspended, it is checked
+        // against the memory budget of the cache. The Core cannot measure it, the default returns 0, so the budget only
+        // limits plugins overriding memoryUsage(), all others are only limited by the number of cached instances.
+        virtual void suspend();
+        virtual void resume();
+        [[nodiscard]] virtual std::size_t memoryUsage() const;
+
+        // In on-demand rendering mode, frames are only rendered after input, resize or GUI interaction. Plugins
+        // changing their image on their own, e.g., after loading data in the background, request a new frame with
+        // requestRedraw() (thread-safe). Animated plugins enable continuous rendering while the animation runs.
+        // Without on-demand rendering, every frame is rendered anyway.
+        void requestRedraw() const;
+        void setContinuousRendering(bool continuous);
+        [[nodiscard]] inline bool isContinuousRendering() const {
+            return continuousRendering_;
+        }
+
+        // By default, render() is called every frame. Plugins whose image only changes on known occasions can enable
+        // frame caching and call invalidateFrame() whenever the image changes, e.g., on own input handling, changed
+        // GUI parameters or when data loaded in the background is ready (thread-safe). The Core then keeps the last
+        // image and calls render() only for an invalid frame. Resize, camera control by the Core and continuous
+        // rendering always invalidate the frame. The GUI of these plugins must be created in renderGui(), which is
+        // called every frame before render().
+        virtual void renderGui();
+        void invalidateFrame();
+        void setFrameCaching(bool caching);
+        [[nodiscard]] inline bool isFrameCaching() const {
+            return frameCaching_;
+        }
+
+        // Screenshots larger than one tile are rendered in tiles: the plugin is resized to the tile size and render()
+        // is called once per tile. Plugins supporting this multiply their projection matrix from the left with
+        // Core::getTileProjection() and base the aspect ratio on the full image size of Core::getTile(). All other
+        // plugins are resized to the full size and rendered with a shifted viewport per tile, which is limited by the
+        // maximum viewport size and requires that the plugin uses the viewport of Core::bindDefaultFramebuffer().
+        inline void setTiledRendering(bool tiled) {
+            tiledRendering_ = tiled;
+        }
+        [[nodiscard]] inline bool isTiledRendering() const {
+            return tiledRendering_;
+        }
+
         [[nodiscard]] std::filesystem::path getResourcePath(const std::string& name) const;
         [[nodiscard]] std::filesystem::path getResourceFilePath(const std::string& name) const;
         [[nodiscard]] std::filesystem::path getResourceDirPath(const std::string& name) const;
+        // Strings, images and textures are loaded through the resource cache of the Core, which shares them between
+        // plugin instances and keeps them across plugin switches until the file changes. The shared values and
+        // textures must not be modified.
         [[nodiscard]] std::string getStringResource(const std::string& name) const;
+        [[nodiscard]] std::shared_ptr<const std::string> getSharedStringResource(const std::string& name) const;
+        [[nodiscard]] Image getPngResource(const std::string& name) const;
+        [[nodiscard]] std::shared_ptr<const Image> getSharedPngResource(const std::string& name) const;
         [[nodiscard]] std::vector<unsigned char> getPngResource(const std::string& name, int& width, int& height) const;
         [[nodiscard]] std::shared_ptr<glowl::Texture2D> getTextureResource(const std::string& name) const;
+        // Returns immediately, the image is decoded in the background and uploaded over the next frames. The handle
+        // returns a placeholder texture until the texture is ready, the frame is invalidated when it is ready.
+        [[nodiscard]] std::shared_ptr<AsyncTexture> getTextureResourceAsync(const std::string& name) const;
         [[nodiscard]] std::vector<std::filesystem::path> getResourceDirFilePaths(const std::string& name,
             const std::string& filter = std::string()) const;
+        // Load the PNG files of getResourceDirFilePaths() as layers (slices) in file name order, decoded in parallel,
+        // see TextureArrayLoader. All images must have the same size. The progress is shown by the loading overlay
+        // while the plugin is constructed in the background.
+        [[nodiscard]] std::shared_ptr<glowl::Texture2DArray> getTextureArrayResource(const std::string& name,
+            const std::string& filter = std::string()) const;
+        [[nodiscard]] std::shared_ptr<glowl::Texture3D> getTexture3DResource(const std::string& name,
+            const std::string& filter = std::string()) const;
 
     protected:
         const Core& core_;
+
+    private:
+        friend class Core;
+
+        // Reports the progress of loading the resource to the loading overlay of the Core.
+        [[nodiscard]] TextureArrayLoader::ProgressCallback loadingProgress(const std::string& name) const;
+
+        bool continuousRendering_;
+        bool frameCaching_;
+        bool tiledRendering_;
+        std::atomic<bool> frameInvalid_; // Reset by the Core after rendering.
     };
 } // namespace OGL4Core2::Core
@@ -0,0 +1,189 @@
+#include "ResourceCache.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <glad/gl.h>
+
+#include "util/GLUtil.h"
+#include "util/ImageUtil.h"
+
+using namespace OGL4Core2::Core;
+
+ResourceCache::ResourceCache(const TextureCooker& cooker, std::size_t memoryBudget)
+    : cooker_(cooker),
+      memoryBudget_(memoryBudget),
+      memoryUsage_(0),
+      hits_(0),
+      misses_(0) {}
+
+std::shared_ptr<const std::string> ResourceCache::getString(const std::filesystem::path& path) {
+    return std::static_pointer_cast<const std::string>(get(Type::String, path, [&path](std::size_t& memoryUsage) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot read resource file \"" + path.string() + "\"!");
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        auto value = std::make_shared<std::string>(buffer.str());
+        memoryUsage = value->size();
+        return value;
+    }));
+}
+
+std::shared_ptr<const Image> ResourceCache::getImage(const std::filesystem::path& path) {
+    return std::static_pointer_cast<const Image>(get(Type::Image, path, [&path](std::size_t& memoryUsage) {
+        auto value = std::make_shared<Image>(ImageUtil::loadPngImage(path));
+        memoryUsage = value->pixels.size();
+        return value;
+    }));
+}
+
+std::shared_ptr<glowl::Texture2D> ResourceCache::getTexture(const std::filesystem::path& path) {
+    auto load = [this, &path](std::size_t& memoryUsage) {
+        // The mipmaps are not cached in memory, they are not needed anymore after the upload.
+        const MipChain chain = cooker_.load(path);
+        auto value = createTexture(path.filename().string(), chain.width, chain.height, chain.numLevels());
+        for (int level = 0; level < chain.numLevels(); level++) {
+            GLUtil::uploadImage(value->getName(), chain.level(level), level);
+        }
+        memoryUsage = chain.memoryUsage();
+        return value;
+    };
+    return std::static_pointer_cast<glowl::Texture2D>(get(Type::Texture, path, load));
+}
+
+std::shared_ptr<glowl::Texture2D> ResourceCache::findTexture(const std::filesystem::path& path) {
+    return std::static_pointer_cast<glowl::Texture2D>(find(makeEntry(Type::Texture, path)));
+}
+
+void ResourceCache::insertTexture(const std::filesystem::path& path, std::shared_ptr<glowl::Texture2D> texture,
+    std::size_t memoryUsage) {
+    Entry entry = makeEntry(Type::Texture, path);
+    entry.value = std::move(texture);
+    entry.memoryUsage = memoryUsage;
+    insert(std::move(entry));
+}
+
+std::shared_ptr<glowl::Texture2D> ResourceCache::createTexture(const std::string& id, int width, int height,
+    int levels) {
+    glowl::TextureLayout layout(GL_RGBA8, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, levels,
+        {
+            {GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE},
+            {GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE},
+            {GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR},
+            {GL_TEXTURE_MAG_FILTER, GL_LINEAR},
+        },
+        {});
+    // The levels are uploaded by the caller, instead of generated by OpenGL.
+    return std::make_shared<glowl::Texture2D>(id, layout, nullptr, false, true);
+}
+
+void ResourceCache::clear() {
+    // Destroy the values outside of the lock, callers may wait meanwhile.
+    std::list<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries.swap(entries_);
+        index_.clear();
+        memoryUsage_ = 0;
+    }
+}
+
+void ResourceCache::setMemoryBudget(std::size_t memoryBudget) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memoryBudget_ = memoryBudget;
+    shrink();
+}
+
+std::size_t ResourceCache::memoryBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryBudget_;
+}
+
+std::size_t ResourceCache::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryUsage_;
+}
+
+std::size_t ResourceCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::size_t ResourceCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+std::size_t ResourceCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::shared_ptr<void> ResourceCache::get(Type type, const std::filesystem::path& path,
+    const std::function<std::shared_ptr<void>(std::size_t& memoryUsage)>& load) {
+    Entry entry = makeEntry(type, path);
+    if (auto value = find(entry)) {
+        return value;
+    }
+    entry.value = load(entry.memoryUsage);
+    auto value = entry.value;
+    insert(std::move(entry));
+    return value;
+}
+
+ResourceCache::Entry ResourceCache::makeEntry(Type type, const std::filesystem::path& path) {
+    // Different spellings of the same file share the entry.
+    std::error_code ec;
+    std::filesystem::path resolved = std::filesystem::canonical(path, ec);
+    if (ec) {
+        resolved = path;
+    }
+    Entry entry;
+    entry.key = Key(type, resolved.string());
+    entry.writeTime = std::filesystem::last_write_time(resolved);
+    entry.fileSize = std::filesystem::file_size(resolved);
+    return entry;
+}
+
+std::shared_ptr<void> ResourceCache::find(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(entry.key);
+    if (it != index_.end() && it->second->writeTime == entry.writeTime && it->second->fileSize == entry.fileSize) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        hits_++;
+        return entries_.front().value;
+    }
+    misses_++;
+    return nullptr;
+}
+
+void ResourceCache::insert(Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // An outdated version, or the same version loaded by another thread meanwhile, is replaced.
+    if (const auto it = index_.find(entry.key); it != index_.end()) {
+        erase(it->second);
+    }
+    memoryUsage_ += entry.memoryUsage;
+    const Key key = entry.key;
+    entries_.push_front(std::move(entry));
+    index_[key] = entries_.begin();
+    shrink();
+}
+
+void ResourceCache::erase(std::list<Entry>::iterator it) {
+    memoryUsage_ -= it->memoryUsage;
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+void ResourceCache::shrink() {
+    // The most recently used entry is kept, even if it exceeds the budget alone.
+    while (entries_.size() > 1 && memoryBudget_ > 0 && memoryUsage_ > memoryBudget_) {
+        erase(std::prev(entries_.end()));
+    }
+}
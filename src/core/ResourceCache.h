@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <glowl/Texture2D.hpp>
+
+#include "util/Image.h"
+#include "util/TextureCooker.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Resource files loaded by the RenderPlugin resource getters, shared by all plugin instances and kept across plugin
+     * switches. Entries are keyed by the resolved file path and the kind of resource (string, decoded image, texture)
+     * and are loaded again when the modification time or size of the file changed. Textures have a full mipmap chain
+     * and are loaded through the TextureCooker. Values are shared with the callers and must not be modified. The least
+     * recently used entries are released when the memory usage exceeds the budget, callers still holding a value keep
+     * it alive.
+     *
+     * All methods are thread-safe. Textures must be requested from a thread with a current OpenGL context sharing its
+     * objects with the main context, also the cache must be cleared before the context is destroyed.
+     */
+    class ResourceCache {
+    public:
+        /**
+         * @param cooker Loads the textures.
+         * @param memoryBudget Maximum memory usage of all entries in bytes, 0 for no limit.
+         */
+        explicit ResourceCache(const TextureCooker& cooker, std::size_t memoryBudget = 0);
+        ~ResourceCache() = default;
+
+        ResourceCache(const ResourceCache&) = delete;
+        ResourceCache(ResourceCache&&) = delete;
+        ResourceCache& operator=(const ResourceCache&) = delete;
+        ResourceCache& operator=(ResourceCache&&) = delete;
+
+        /**
+         * @param path Existing file.
+         * @return Content of the text file.
+         */
+        [[nodiscard]] std::shared_ptr<const std::string> getString(const std::filesystem::path& path);
+
+        /**
+         * @param path Existing PNG file.
+         * @return RGBA image with the rows in file order (top-down).
+         */
+        [[nodiscard]] std::shared_ptr<const Image> getImage(const std::filesystem::path& path);
+
+        /**
+         * @param path Existing PNG file.
+         * @return RGBA texture of the image with all mipmap levels.
+         */
+        [[nodiscard]] std::shared_ptr<glowl::Texture2D> getTexture(const std::filesystem::path& path);
+
+        /**
+         * Look up a texture without loading it, e.g., before loading it asynchronously.
+         *
+         * @param path Existing PNG file.
+         * @return Cached texture, nullptr if the texture is not cached or the file changed.
+         */
+        [[nodiscard]] std::shared_ptr<glowl::Texture2D> findTexture(const std::filesystem::path& path);
+
+        /**
+         * Add a texture of the file loaded outside of the cache, e.g., asynchronously.
+         *
+         * @param path Existing PNG file.
+         * @param texture
+         * @param memoryUsage Bytes.
+         */
+        void insertTexture(const std::filesystem::path& path, std::shared_ptr<glowl::Texture2D> texture,
+            std::size_t memoryUsage);
+
+        /**
+         * Create the texture storage for a RGBA image of the given size, as used for all textures of the cache.
+         * Textures with more than one level use trilinear filtering.
+         *
+         * @param id Name of the texture.
+         * @param width
+         * @param height
+         * @param levels Number of mipmap levels.
+         */
+        [[nodiscard]] static std::shared_ptr<glowl::Texture2D> createTexture(const std::string& id, int width,
+            int height, int levels = 1);
+
+        void clear();
+
+        void setMemoryBudget(std::size_t memoryBudget);
+
+        [[nodiscard]] std::size_t memoryBudget() const;
+        [[nodiscard]] std::size_t memoryUsage() const;
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] std::size_t hits() const;
+        [[nodiscard]] std::size_t misses() const;
+
+    private:
+        enum class Type {
+            String,
+            Image,
+            Texture,
+        };
+
+        using Key = std::pair<Type, std::string>;
+
+        struct Entry {
+            Key key;
+            std::filesystem::file_time_type writeTime;
+            std::uintmax_t fileSize = 0;
+            std::shared_ptr<void> value;
+            std::size_t memoryUsage = 0;
+        };
+
+        /**
+         * Cached value of the file, the value is loaded without holding the lock on a miss.
+         *
+         * @param type
+         * @param path
+         * @param load Loads the value and returns its memory usage in bytes.
+         */
+        std::shared_ptr<void> get(Type type, const std::filesystem::path& path,
+            const std::function<std::shared_ptr<void>(std::size_t& memoryUsage)>& load);
+        static Entry makeEntry(Type type, const std::filesystem::path& path);
+        std::shared_ptr<void> find(const Entry& entry);
+        void insert(Entry entry);
+        void erase(std::list<Entry>::iterator it);
+        void shrink();
+
+        const TextureCooker& cooker_;
+        mutable std::mutex mutex_;
+        std::size_t memoryBudget_;
+        std::list<Entry> entries_; // Most recently used first.
+        std::map<Key, std::list<Entry>::iterator> index_;
+        std::size_t memoryUsage_;
+        std::size_t hits_;
+        std::size_t misses_;
+    };
+} // namespace OGL4Core2::Core
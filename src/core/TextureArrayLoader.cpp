@@ -0,0 +1,187 @@
+#include "TextureArrayLoader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "util/Image.h"
+#include "util/ImageUtil.h"
+#include "util/Profiler.h"
+#include "util/UploadBuffer.h"
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    glowl::TextureLayout layerLayout(int width, int height, std::size_t depth) {
+        return glowl::TextureLayout(GL_RGBA8, width, height, static_cast<int>(depth), GL_RGBA, GL_UNSIGNED_BYTE, 1,
+            {
+                {GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE},
+                {GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE},
+                {GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE},
+                {GL_TEXTURE_MIN_FILTER, GL_LINEAR},
+                {GL_TEXTURE_MAG_FILTER, GL_LINEAR},
+            },
+            {});
+    }
+
+    std::string sizeString(int width, int height) {
+        return std::to_string(width) + "x" + std::to_string(height);
+    }
+} // namespace
+
+std::shared_ptr<glowl::Texture2DArray> TextureArrayLoader::loadTextureArray(const std::string& id,
+    const std::vector<std::filesystem::path>& files, const ProgressCallback& progress, std::size_t numThreads) {
+    std::shared_ptr<glowl::Texture2DArray> texture;
+    loadLayers(
+        files,
+        [&](int width, int height) {
+            texture = std::make_shared<glowl::Texture2DArray>(id, layerLayout(width, height, files.size()), nullptr);
+            return texture->getName();
+        },
+        progress, numThreads);
+    return texture;
+}
+
+std::shared_ptr<glowl::Texture3D> TextureArrayLoader::loadTexture3D(const std::string& id,
+    const std::vector<std::filesystem::path>& files, const ProgressCallback& progress, std::size_t numThreads) {
+    std::shared_ptr<glowl::Texture3D> texture;
+    loadLayers(
+        files,
+        [&](int width, int height) {
+            texture = std::make_shared<glowl::Texture3D>(id, layerLayout(width, height, files.size()), nullptr);
+            return texture->getName();
+        },
+        progress, numThreads);
+    return texture;
+}
+
+void TextureArrayLoader::loadLayers(const std::vector<std::filesystem::path>& files,
+    const std::function<GLuint(int width, int height)>& create, const ProgressCallback& progress,
+    std::size_t numThreads) {
+    if (files.empty()) {
+        throw std::invalid_argument("Texture array needs at least one image!");
+    }
+    if (numThreads == 0) {
+        // The calling thread only uploads, so all hardware threads decode.
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, files.size());
+    const std::size_t maxDecoded = 2 * numThreads;
+
+    struct Slot {
+        std::size_t layer = 0;
+        Image image;
+        std::exception_ptr error;
+    };
+    std::deque<Slot> decoded;
+    std::size_t nextLayer = 0;
+    std::size_t activeJobs = 0;
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable decodedAvailable;
+    std::condition_variable slotAvailable;
+
+    auto worker = [&]() {
+        Profiler::setThreadName("TextureArrayLoader");
+        while (true) {
+            std::size_t layer = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotAvailable.wait(lock, [&] {
+                    return stop || nextLayer == files.size() || decoded.size() + activeJobs < maxDecoded;
+                });
+                if (stop || nextLayer == files.size()) {
+                    return;
+                }
+                layer = nextLayer++;
+                activeJobs++;
+            }
+
+            Slot slot;
+            slot.layer = layer;
+            try {
+                OGL4CORE2_PROFILE_ZONE("TextureArrayLoader decode");
+                slot.image = ImageUtil::loadPngImage(files[layer]);
+            } catch (const std::exception& ex) {
+                slot.error = std::make_exception_ptr(
+                    std::runtime_error("Cannot load \"" + files[layer].string() + "\": " + ex.what()));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                decoded.push_back(std::move(slot));
+                activeJobs--;
+            }
+            decodedAvailable.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    // Workers are joined on errors too, they reference the local state.
+    auto joinWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        slotAvailable.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    };
+
+    try {
+        // Reused for all layers, the decoded images are top-down.
+        UploadBuffer uploadBuffer;
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+        std::size_t firstLayer = 0;
+        // Layers are uploaded in the order they finish decoding.
+        for (std::size_t loaded = 0; loaded < files.size(); loaded++) {
+            Slot slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                decodedAvailable.wait(lock, [&] { return !decoded.empty(); });
+                slot = std::move(decoded.front());
+                decoded.pop_front();
+            }
+            slotAvailable.notify_one();
+
+            if (slot.error) {
+                std::rethrow_exception(slot.error);
+            }
+            const ImageView view = slot.image.view();
+            if (texture == 0) {
+                width = view.width;
+                height = view.height;
+                firstLayer = slot.layer;
+                texture = create(width, height);
+            } else if (view.width != width || view.height != height) {
+                throw std::runtime_error("Image \"" + files[slot.layer].string() + "\" has size " +
+                                         sizeString(view.width, view.height) + ", but \"" +
+                                         files[firstLayer].string() + "\" has size " + sizeString(width, height) +
+                                         "!");
+            }
+            {
+                OGL4CORE2_PROFILE_ZONE("TextureArrayLoader upload");
+                uploadBuffer.uploadImage(texture, view, 0, static_cast<GLint>(slot.layer));
+            }
+            if (progress) {
+                progress(loaded + 1, files.size());
+            }
+        }
+    } catch (...) {
+        joinWorkers();
+        throw;
+    }
+    joinWorkers();
+}
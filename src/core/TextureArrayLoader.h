@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glowl/Texture2DArray.hpp>
+#include <glowl/Texture3D.hpp>
+
+namespace OGL4Core2::Core {
+    /**
+     * Loads a stack of PNG images, e.g., the slices of a volume, into the layers of a single GL_TEXTURE_2D_ARRAY or
+     * the slices of a GL_TEXTURE_3D. The images are decoded in parallel by a pool of threads, while the calling thread
+     * uploads each image as soon as it is decoded. Decoding runs at most a few images ahead of the upload, which
+     * bounds the memory of decoded images independent of the number of files.
+     *
+     * All images must have the same size. The calling thread must have a current OpenGL context.
+     */
+    class TextureArrayLoader {
+    public:
+        // Called on the calling thread after each uploaded image.
+        using ProgressCallback = std::function<void(std::size_t loaded, std::size_t total)>;
+
+        /**
+         * @param id Name of the texture.
+         * @param files PNG files, in layer order.
+         * @param progress Optional.
+         * @param numThreads Number of decoding threads, 0 selects the number of hardware threads.
+         * @return RGBA texture array with one layer per file.
+         */
+        [[nodiscard]] static std::shared_ptr<glowl::Texture2DArray> loadTextureArray(const std::string& id,
+            const std::vector<std::filesystem::path>& files, const ProgressCallback& progress = nullptr,
+            std::size_t numThreads = 0);
+
+        /**
+         * See loadTextureArray(), but for a 3D texture with one slice per file, e.g., for volume rendering.
+         */
+        [[nodiscard]] static std::shared_ptr<glowl::Texture3D> loadTexture3D(const std::string& id,
+            const std::vector<std::filesystem::path>& files, const ProgressCallback& progress = nullptr,
+            std::size_t numThreads = 0);
+
+    private:
+        /**
+         * @param files
+         * @param create Creates the texture storage for the size of the images, called with the first decoded image.
+         * @param progress
+         * @param numThreads
+         */
+        static void loadLayers(const std::vector<std::filesystem::path>& files,
+            const std::function<GLuint(int width, int height)>& create, const ProgressCallback& progress,
+            std::size_t numThreads);
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,256 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "ResourceCache.h"
+#include "util/GLUtil.h"
+#include "util/Profiler.h"
+
+using namespace OGL4Core2::Core;
+
+AsyncTexture::AsyncTexture(std::shared_ptr<glowl::Texture2D> texture, bool ready)
+    : texture_(std::move(texture)),
+      ready_(ready),
+      progress_(ready ? 1.0f : 0.0f) {}
+
+TextureStreamer::TextureStreamer(const TextureCooker& cooker, std::size_t uploadBudget, std::size_t numThreads)
+    : cooker_(cooker),
+      segmentSize_(uploadBudget - uploadBudget % ImageView::pixelSize),
+      buffer_(0),
+      mapped_(nullptr),
+      fences_{},
+      segment_(0),
+      placeholder_(nullptr),
+      activeJobs_(0),
+      stop_(false) {
+    if (segmentSize_ == 0) {
+        throw std::invalid_argument("Texture upload budget must be at least one pixel!");
+    }
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto bufferSize = static_cast<GLsizeiptr>(segmentSize_ * numSegments);
+    glCreateBuffers(1, &buffer_);
+    glNamedBufferStorage(buffer_, bufferSize, nullptr, flags);
+    mapped_ = static_cast<unsigned char*>(glMapNamedBufferRange(buffer_, 0, bufferSize, flags));
+    if (mapped_ == nullptr) {
+        glDeleteBuffers(1, &buffer_);
+        throw std::runtime_error("Cannot map texture staging buffer!");
+    }
+
+    // Neutral gray, which neither stands out on bright nor on dark surfaces.
+    placeholder_ = ResourceCache::createTexture("placeholder", 1, 1);
+    const unsigned char gray[ImageView::pixelSize] = {128, 128, 128, 255};
+    glTextureSubImage2D(placeholder_->getName(), 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+
+    if (numThreads == 0) {
+        // Leave some threads for rendering.
+        numThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    threads_.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; i++) {
+        threads_.emplace_back(&TextureStreamer::worker, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    jobAvailable_.notify_all();
+    // Workers only finish the image they are decoding.
+    for (auto& t : threads_) {
+        t.join();
+    }
+    for (auto& fence : fences_) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+    glUnmapNamedBuffer(buffer_);
+    glDeleteBuffers(1, &buffer_);
+}
+
+std::shared_ptr<AsyncTexture> TextureStreamer::load(const std::filesystem::path& path, ReadyCallback onReady) {
+    auto handle = std::make_shared<AsyncTexture>(placeholder_, false);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Job job;
+        job.path = path;
+        job.handle = handle;
+        job.onReady = std::move(onReady);
+        queue_.push_back(std::move(job));
+    }
+    jobAvailable_.notify_one();
+    return handle;
+}
+
+bool TextureStreamer::update(bool wait) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wait) {
+            idle_.wait(lock, [this] { return queue_.empty() && activeJobs_ == 0; });
+        }
+        std::move(decoded_.begin(), decoded_.end(), std::back_inserter(uploads_));
+        decoded_.clear();
+    }
+    if (uploads_.empty()) {
+        return false;
+    }
+    OGL4CORE2_PROFILE_ZONE("TextureStreamer::update");
+
+    if (wait) {
+        for (auto& job : uploads_) {
+            if (!job.handle.expired() && job.error.empty()) {
+                uploadRemaining(job);
+            }
+            finish(job);
+        }
+        uploads_.clear();
+        return true;
+    }
+
+    // The segment was last written numSegments frames ago, so the fence is usually signaled already. Otherwise, the
+    // GPU is behind and the uploads wait for the next frame instead of stalling this one.
+    GLsync& fence = fences_[segment_];
+    if (fence != nullptr) {
+        const GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    const std::size_t offset = segment_ * segmentSize_;
+    std::size_t used = 0;
+    bool changed = false;
+    while (!uploads_.empty()) {
+        Job& job = uploads_.front();
+        if (!job.handle.expired() && job.error.empty() && !upload(job, offset, used)) {
+            break;
+        }
+        changed = !job.handle.expired() || changed;
+        finish(job);
+        uploads_.pop_front();
+    }
+    if (used > 0) {
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment_ = (segment_ + 1) % numSegments;
+    }
+    return changed;
+}
+
+bool TextureStreamer::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !queue_.empty() || activeJobs_ > 0 || !decoded_.empty() || !uploads_.empty();
+}
+
+void TextureStreamer::worker() {
+    Profiler::setThreadName("TextureStreamer");
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobAvailable_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            activeJobs_++;
+        }
+
+        // Nobody waits for the texture of a released handle.
+        if (!job.handle.expired()) {
+            try {
+                OGL4CORE2_PROFILE_ZONE("TextureStreamer load");
+                job.chain = cooker_.load(job.path);
+            } catch (const std::exception& ex) {
+                job.error = ex.what();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!job.handle.expired()) {
+                decoded_.push_back(std::move(job));
+            }
+            activeJobs_--;
+        }
+        idle_.notify_all();
+    }
+}
+
+void TextureStreamer::finish(Job& job) {
+    const auto handle = job.handle.lock();
+    if (handle == nullptr) {
+        return;
+    }
+    if (!job.error.empty()) {
+        std::cerr << "Cannot load texture \"" << job.path.string() << "\": " << job.error << std::endl;
+        handle->error_ = job.error;
+        return;
+    }
+    handle->texture_ = job.texture;
+    handle->ready_ = true;
+    handle->progress_ = 1.0f;
+    if (job.onReady) {
+        job.onReady(job.texture, job.chain.memoryUsage());
+    }
+}
+
+bool TextureStreamer::upload(Job& job, std::size_t offset, std::size_t& used) {
+    if (job.chain.level(0).rowSize() > segmentSize_) {
+        // A single row exceeds the staging segment, upload the texture directly instead.
+        uploadRemaining(job);
+        return true;
+    }
+    if (job.texture == nullptr) {
+        job.texture = ResourceCache::createTexture(job.path.filename().string(), job.chain.width, job.chain.height,
+            job.chain.numLevels());
+    }
+    while (job.level < job.chain.numLevels()) {
+        const ImageView view = job.chain.level(job.level);
+        const std::size_t rowSize = view.rowSize();
+        const int rows = std::min(view.height - job.uploadedRows, static_cast<int>((segmentSize_ - used) / rowSize));
+        if (rows == 0) {
+            break;
+        }
+        // The levels are stored bottom-up and tightly packed, so the rows are staged with a single copy.
+        const std::size_t size = static_cast<std::size_t>(rows) * rowSize;
+        std::copy_n(view.rowFromBottom(job.uploadedRows), size, mapped_ + offset + used);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTextureSubImage2D(job.texture->getName(), job.level, 0, job.uploadedRows, view.width, rows, GL_RGBA,
+            GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset + used));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        used += size;
+        job.uploadedBytes += size;
+        job.uploadedRows += rows;
+        if (job.uploadedRows == view.height) {
+            job.level++;
+            job.uploadedRows = 0;
+        }
+    }
+    if (const auto handle = job.handle.lock(); handle != nullptr) {
+        handle->progress_ = static_cast<float>(job.uploadedBytes) / static_cast<float>(job.chain.memoryUsage());
+    }
+    return job.level == job.chain.numLevels();
+}
+
+void TextureStreamer::uploadRemaining(Job& job) {
+    if (job.texture == nullptr) {
+        job.texture = ResourceCache::createTexture(job.path.filename().string(), job.chain.width, job.chain.height,
+            job.chain.numLevels());
+    }
+    // The level in progress is uploaded again completely, this is only used for a complete upload at once.
+    for (; job.level < job.chain.numLevels(); job.level++) {
+        GLUtil::uploadImage(job.texture->getName(), job.chain.level(job.level), job.level);
+    }
+    job.uploadedRows = 0;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glowl/Texture2D.hpp>
+
+#include "util/TextureCooker.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Handle of a texture loaded by the TextureStreamer. Until the texture is ready, texture() returns a placeholder
+     * texture, so the handle can be bound right away. All methods must be called on the main thread.
+     */
+    class AsyncTexture {
+    public:
+        /**
+         * @param texture Initial texture, the placeholder while loading.
+         * @param ready True if the texture is the final texture, e.g., found in the resource cache.
+         */
+        AsyncTexture(std::shared_ptr<glowl::Texture2D> texture, bool ready);
+
+        [[nodiscard]] inline const std::shared_ptr<glowl::Texture2D>& texture() const {
+            return texture_;
+        }
+        [[nodiscard]] inline bool ready() const {
+            return ready_;
+        }
+        // Loading failed, the placeholder is kept.
+        [[nodiscard]] inline bool failed() const {
+            return !error_.empty();
+        }
+        [[nodiscard]] inline const std::string& error() const {
+            return error_;
+        }
+        // Uploaded part of the texture in range [0, 1].
+        [[nodiscard]] inline float progress() const {
+            return progress_;
+        }
+
+    private:
+        friend class TextureStreamer;
+
+        std::shared_ptr<glowl::Texture2D> texture_;
+        bool ready_;
+        std::string error_;
+        float progress_;
+    };
+
+    /**
+     * Loads PNG textures without stalling the main thread. Textures are loaded by a pool of worker threads through the
+     * TextureCooker, update() then uploads the rows of all mipmap levels through a persistently mapped pixel unpack
+     * buffer, at most the upload budget per frame. The buffer is split into one segment per frame in flight, each
+     * guarded by a fence, so the CPU never writes into a segment the GPU still reads from. Fences are only polled,
+     * while the GPU still reads the next segment, the uploads wait for the next frame. Finished textures replace
+     * the placeholder of their handle.
+     *
+     * Jobs whose handle was released before the texture is ready are dropped. The streamer must be created and
+     * destroyed with the main OpenGL context current.
+     */
+    class TextureStreamer {
+    public:
+        // Called on the main thread when a texture is ready, e.g., to add it to the resource cache.
+        using ReadyCallback = std::function<void(const std::shared_ptr<glowl::Texture2D>& texture,
+            std::size_t memoryUsage)>;
+
+        /**
+         * @param cooker Loads the textures on the worker threads.
+         * @param uploadBudget Maximum bytes uploaded per frame, also the size of one segment of the staging buffer.
+         * @param numThreads Number of decoding threads, 0 selects a number based on the available hardware threads.
+         */
+        TextureStreamer(const TextureCooker& cooker, std::size_t uploadBudget, std::size_t numThreads = 0);
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer(TextureStreamer&&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+        /**
+         * Queue a PNG file for loading, can be called from any thread. Errors are reported by the handle.
+         *
+         * @param path
+         * @param onReady Optional, called when the texture is ready.
+         * @return Handle, showing the placeholder texture until the texture is ready.
+         */
+        [[nodiscard]] std::shared_ptr<AsyncTexture> load(const std::filesystem::path& path,
+            ReadyCallback onReady = nullptr);
+
+        /**
+         * Upload the next rows of loaded textures, called once per frame on the main thread.
+         *
+         * @param wait Wait for all queued images and upload them completely, ignoring the budget.
+         * @return True if at least one texture became ready or failed.
+         */
+        bool update(bool wait = false);
+
+        // Textures are queued, loading or waiting for the upload.
+        [[nodiscard]] bool busy() const;
+
+        [[nodiscard]] inline const std::shared_ptr<glowl::Texture2D>& placeholder() const {
+            return placeholder_;
+        }
+        [[nodiscard]] inline std::size_t uploadBudget() const {
+            return segmentSize_;
+        }
+
+    private:
+        static constexpr std::size_t numSegments = 3;
+
+        struct Job {
+            std::filesystem::path path;
+            std::weak_ptr<AsyncTexture> handle;
+            ReadyCallback onReady;
+            MipChain chain;
+            std::string error;
+            std::shared_ptr<glowl::Texture2D> texture; // Created with the first uploaded rows.
+            int level = 0; // Next level to upload.
+            int uploadedRows = 0; // Of the level.
+            std::size_t uploadedBytes = 0;
+        };
+
+        void worker();
+        void finish(Job& job);
+        // Returns false if the segment is full before the job is complete.
+        bool upload(Job& job, std::size_t offset, std::size_t& used);
+        void uploadRemaining(Job& job);
+
+        const TextureCooker& cooker_;
+        std::size_t segmentSize_;
+        GLuint buffer_;
+        unsigned char* mapped_;
+        std::array<GLsync, numSegments> fences_;
+        std::size_t segment_;
+        std::shared_ptr<glowl::Texture2D> placeholder_;
+
+        std::deque<Job> queue_;   // Waiting for loading.
+        std::deque<Job> decoded_; // Loaded, waiting for the upload.
+        std::deque<Job> uploads_; // Main thread only.
+        std::size_t activeJobs_;
+        bool stop_;
+        mutable std::mutex mutex_;
+        std::condition_variable jobAvailable_;
+        std::condition_variable idle_;
+        std::vector<std::thread> threads_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,268 @@
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "JsonUtil.h"
+
+using namespace OGL4Core2::Core;
+
+static void writeJsonNumber(std::ostream& os, double value) {
+    if (std::isfinite(value)) {
+        os << value;
+    } else {
+        os << "null";
+    }
+}
+
+static void writeJsonStatistics(std::ostream& os, const BenchmarkReport::Statistics& stats) {
+    os << "{\"count\": " << stats.count << ", \"mean\": " << stats.mean << ", \"min\": " << stats.min
+       << ", \"max\": " << stats.max << ", \"p50\": " << stats.p50 << ", \"p95\": " << stats.p95
+       << ", \"p99\": " << stats.p99 << "}";
+}
+
+static void writeJsonSamples(std::ostream& os, const std::vector<double>& samples) {
+    os << "[";
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        writeJsonNumber(os, samples[i]);
+    }
+    os << "]";
+}
+
+static void writeStatisticsLine(std::ostream& os, const std::string& name, const BenchmarkReport::Statistics& stats) {
+    os << "  " << name << " [ms]: mean " << stats.mean << ", min " << stats.min << ", p50 " << stats.p50 << ", p95 "
+       << stats.p95 << ", p99 " << stats.p99 << ", max " << stats.max << " (" << stats.count << " frames)"
+       << std::endl;
+}
+
+static std::ofstream openReportFile(const std::filesystem::path& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + filename.string() + "\"!");
+    }
+    file << std::setprecision(6);
+    return file;
+}
+
+BenchmarkReport::BenchmarkReport(Info info) : info_(std::move(info)) {
+    cpuTimes_.resize(info_.frames, std::numeric_limits<double>::quiet_NaN());
+    gpuTimes_.resize(info_.frames, std::numeric_limits<double>::quiet_NaN());
+}
+
+void BenchmarkReport::setCpuTime(std::size_t frameIdx, double ms) {
+    if (frameIdx < cpuTimes_.size()) {
+        cpuTimes_[frameIdx] = ms;
+    }
+}
+
+void BenchmarkReport::setGpuTime(std::size_t frameIdx, double ms) {
+    if (frameIdx < gpuTimes_.size()) {
+        gpuTimes_[frameIdx] = ms;
+    }
+}
+
+void BenchmarkReport::addGpuScopeTime(const std::string& name, std::size_t frameIdx, double ms) {
+    if (frameIdx >= gpuTimes_.size()) {
+        return;
+    }
+    auto it = std::find_if(gpuScopeTimes_.begin(), gpuScopeTimes_.end(),
+        [&name](const auto& scope) { return scope.first == name; });
+    if (it == gpuScopeTimes_.end()) {
+        gpuScopeTimes_.emplace_back(name,
+            std::vector<double>(gpuTimes_.size(), std::numeric_limits<double>::quiet_NaN()));
+        it = std::prev(gpuScopeTimes_.end());
+    }
+    double& sample = it->second[frameIdx];
+    sample = std::isfinite(sample) ? sample + ms : ms;
+}
+
+BenchmarkReport::Statistics BenchmarkReport::cpuStatistics() const {
+    return computeStatistics(cpuTimes_);
+}
+
+BenchmarkReport::Statistics BenchmarkReport::gpuStatistics() const {
+    return computeStatistics(gpuTimes_);
+}
+
+void BenchmarkReport::print(std::ostream& os) const {
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    os << "Benchmark \"" << info_.pluginName << "\" (" << info_.width << "x" << info_.height << ", "
+       << info_.warmupFrames << " warmup frames, " << info_.frames << " frames):" << std::endl;
+    if (std::isfinite(info_.constructionMs)) {
+        os << "  Construction: " << info_.constructionMs << " ms, first frame: " << info_.firstFrameMs << " ms"
+           << std::endl;
+    }
+    writeStatisticsLine(os, "CPU", cpuStatistics());
+    writeStatisticsLine(os, "GPU", gpuStatistics());
+    for (const auto& [name, samples] : gpuScopeTimes_) {
+        writeStatisticsLine(os, "GPU \"" + name + "\"", computeStatistics(samples));
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void BenchmarkReport::save(const std::filesystem::path& filename) const {
+    auto file = openReportFile(filename);
+    if (filename.extension() == ".csv") {
+        writeCsv(file);
+    } else {
+        writeJson(file);
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Error writing file: \"" + filename.string() + "\"!");
+    }
+}
+
+void BenchmarkReport::printComparison(std::ostream& os, const std::vector<BenchmarkReport>& reports) {
+    std::size_t nameWidth = 6;
+    for (const auto& report : reports) {
+        nameWidth = std::max(nameWidth, report.info_.pluginName.size());
+    }
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    constexpr int w = 10;
+    os << std::left << std::setw(static_cast<int>(nameWidth)) << "Plugin" << std::right << std::setw(w) << "Constr."
+       << std::setw(w) << "1st frame" << std::setw(w) << "CPU mean" << std::setw(w) << "CPU p95" << std::setw(w)
+       << "CPU p99" << std::setw(w) << "GPU mean" << std::setw(w) << "GPU p95" << std::setw(w) << "GPU p99"
+       << "  [ms]" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for (const auto& report : reports) {
+        const auto cpu = report.cpuStatistics();
+        const auto gpu = report.gpuStatistics();
+        os << std::left << std::setw(static_cast<int>(nameWidth)) << report.info_.pluginName << std::right
+           << std::setw(w) << report.info_.constructionMs << std::setw(w) << report.info_.firstFrameMs
+           << std::setw(w) << cpu.mean << std::setw(w) << cpu.p95 << std::setw(w) << cpu.p99 << std::setw(w)
+           << gpu.mean << std::setw(w) << gpu.p95 << std::setw(w) << gpu.p99 << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void BenchmarkReport::saveComparison(const std::filesystem::path& filename,
+    const std::vector<BenchmarkReport>& reports) {
+    auto file = openReportFile(filename);
+    if (filename.extension() == ".csv") {
+        file << "plugin,construction_ms,first_frame_ms,cpu_mean_ms,cpu_min_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,"
+                "cpu_max_ms,gpu_mean_ms,gpu_min_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms,gpu_max_ms"
+             << std::endl;
+        for (const auto& report : reports) {
+            const auto cpu = report.cpuStatistics();
+            const auto gpu = report.gpuStatistics();
+            file << JsonUtil::csvField(report.info_.pluginName) << "," << report.info_.constructionMs << ","
+                 << report.info_.firstFrameMs << "," << cpu.mean << "," << cpu.min << "," << cpu.p50 << "," << cpu.p95
+                 << "," << cpu.p99 << "," << cpu.max << "," << gpu.mean << "," << gpu.min << "," << gpu.p50 << ","
+                 << gpu.p95 << "," << gpu.p99 << "," << gpu.max << std::endl;
+        }
+    } else {
+        file << "{\"plugins\": [" << std::endl;
+        for (std::size_t i = 0; i < reports.size(); i++) {
+            if (i > 0) {
+                file << "," << std::endl;
+            }
+            reports[i].writeJson(file);
+        }
+        file << "]}" << std::endl;
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Error writing file: \"" + filename.string() + "\"!");
+    }
+}
+
+BenchmarkReport::Statistics BenchmarkReport::computeStatistics(std::vector<double> samples) {
+    samples.erase(std::remove_if(samples.begin(), samples.end(), [](double v) { return !std::isfinite(v); }),
+        samples.end());
+    Statistics stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    const std::size_t n = samples.size();
+    const auto percentile = [&](double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(n)));
+        return samples[std::clamp<std::size_t>(rank, 1, n) - 1];
+    };
+    double sum = 0.0;
+    for (const double v : samples) {
+        sum += v;
+    }
+    stats.count = n;
+    stats.mean = sum / static_cast<double>(n);
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.p50 = percentile(50.0);
+    stats.p95 = percentile(95.0);
+    stats.p99 = percentile(99.0);
+    return stats;
+}
+
+void BenchmarkReport::writeJson(std::ostream& os) const {
+    os << "{" << std::endl;
+    os << "  \"plugin\": \"" << JsonUtil::escape(info_.pluginName) << "\"," << std::endl;
+    os << "  \"renderer\": \"" << JsonUtil::escape(info_.renderer) << "\"," << std::endl;
+    os << "  \"width\": " << info_.width << "," << std::endl;
+    os << "  \"height\": " << info_.height << "," << std::endl;
+    os << "  \"warmupFrames\": " << info_.warmupFrames << "," << std::endl;
+    os << "  \"frames\": " << info_.frames << "," << std::endl;
+    os << "  \"timeStep\": " << info_.timeStep << "," << std::endl;
+    os << "  \"constructionMs\": ";
+    writeJsonNumber(os, info_.constructionMs);
+    os << "," << std::endl << "  \"firstFrameMs\": ";
+    writeJsonNumber(os, info_.firstFrameMs);
+    os << "," << std::endl;
+    os << "  \"cpu\": ";
+    writeJsonStatistics(os, cpuStatistics());
+    os << "," << std::endl << "  \"gpu\": ";
+    writeJsonStatistics(os, gpuStatistics());
+    os << "," << std::endl << "  \"gpuScopes\": {";
+    for (std::size_t i = 0; i < gpuScopeTimes_.size(); i++) {
+        os << (i > 0 ? "," : "") << std::endl << "    \"" << JsonUtil::escape(gpuScopeTimes_[i].first) << "\": ";
+        writeJsonStatistics(os, computeStatistics(gpuScopeTimes_[i].second));
+    }
+    os << (gpuScopeTimes_.empty() ? "" : "\n  ") << "}";
+    os << "," << std::endl << "  \"cpuSamples\": ";
+    writeJsonSamples(os, cpuTimes_);
+    os << "," << std::endl << "  \"gpuSamples\": ";
+    writeJsonSamples(os, gpuTimes_);
+    os << "," << std::endl << "  \"gpuScopeSamples\": {";
+    for (std::size_t i = 0; i < gpuScopeTimes_.size(); i++) {
+        os << (i > 0 ? "," : "") << std::endl << "    \"" << JsonUtil::escape(gpuScopeTimes_[i].first) << "\": ";
+        writeJsonSamples(os, gpuScopeTimes_[i].second);
+    }
+    os << (gpuScopeTimes_.empty() ? "" : "\n  ") << "}";
+    os << std::endl << "}" << std::endl;
+}
+
+void BenchmarkReport::writeCsv(std::ostream& os) const {
+    const auto writeValue = [&os](double value) {
+        os << ",";
+        if (std::isfinite(value)) {
+            os << value;
+        }
+    };
+    os << "frame,cpu_ms,gpu_ms";
+    for (const auto& scope : gpuScopeTimes_) {
+        // Quote names, they may contain separators.
+        os << "," << JsonUtil::csvField("gpu_ms " + scope.first);
+    }
+    os << std::endl;
+    for (std::size_t i = 0; i < cpuTimes_.size(); i++) {
+        os << i;
+        writeValue(cpuTimes_[i]);
+        writeValue(gpuTimes_[i]);
+        for (const auto& scope : gpuScopeTimes_) {
+            writeValue(scope.second[i]);
+        }
+        os << std::endl;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OGL4Core2::Core {
+    /**
+     * Collects CPU and GPU frame times and the GPU times of named scopes (see GpuTimer) of a benchmark run and writes
+     * a report with summary statistics and the per frame samples. Frames are indexed from 0 (first frame after
+     * warmup). Frames without a sample, i.e., if a GPU query result got lost or a scope was not used in a frame, are
+     * ignored in the statistics.
+     */
+    class BenchmarkReport {
+    public:
+        struct Statistics {
+            std::size_t count = 0;
+            double mean = 0.0;
+            double min = 0.0;
+            double max = 0.0;
+            double p50 = 0.0;
+            double p95 = 0.0;
+            double p99 = 0.0;
+        };
+
+        struct Info {
+            std::string pluginName;
+            std::string renderer;
+            int width = 0;
+            int height = 0;
+            uint32_t warmupFrames = 0;
+            uint32_t frames = 0;
+            double timeStep = 0.0;
+            double constructionMs = std::numeric_limits<double>::quiet_NaN(); // Plugin construction (CPU).
+            double firstFrameMs = std::numeric_limits<double>::quiet_NaN(); // First frame without construction (CPU).
+        };
+
+        explicit BenchmarkReport(Info info);
+        ~BenchmarkReport() = default;
+
+        void setCpuTime(std::size_t frameIdx, double ms);
+        void setGpuTime(std::size_t frameIdx, double ms);
+
+        /**
+         * Add the GPU time of a named scope. Times of a scope used multiple times within a frame are summed up.
+         *
+         * @param name
+         * @param frameIdx
+         * @param ms
+         */
+        void addGpuScopeTime(const std::string& name, std::size_t frameIdx, double ms);
+
+        [[nodiscard]] Statistics cpuStatistics() const;
+        [[nodiscard]] Statistics gpuStatistics() const;
+
+        /**
+         * Print a human-readable summary.
+         */
+        void print(std::ostream& os) const;
+
+        /**
+         * Save the report, "*.csv" writes one line per frame, everything else writes JSON with summary and samples.
+         *
+         * @param filename
+         */
+        void save(const std::filesystem::path& filename) const;
+
+        [[nodiscard]] inline const Info& info() const {
+            return info_;
+        }
+
+        /**
+         * Print a table comparing the reports, i.e., of different plugins.
+         *
+         * @param os
+         * @param reports
+         */
+        static void printComparison(std::ostream& os, const std::vector<BenchmarkReport>& reports);
+
+        /**
+         * Save multiple reports, "*.csv" writes one summary line per report, everything else writes JSON with all
+         * reports including their samples.
+         *
+         * @param filename
+         * @param reports
+         */
+        static void saveComparison(const std::filesystem::path& filename, const std::vector<BenchmarkReport>& reports);
+
+        /**
+         * Statistics of all finite values in samples, percentiles use the nearest-rank method.
+         *
+         * @param samples
+         * @return Statistics
+         */
+        static Statistics computeStatistics(std::vector<double> samples);
+
+    private:
+        void writeJson(std::ostream& os) const;
+        void writeCsv(std::ostream& os) const;
+
+        Info info_;
+        std::vector<double> cpuTimes_; // Milliseconds, NaN if missing.
+        std::vector<double> gpuTimes_;
+        std::vector<std::pair<std::string, std::vector<double>>> gpuScopeTimes_; // In order of first use.
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,97 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace OGL4Core2::Core;
+
+// Last part of a wait is spent spinning, because sleeping is not precise enough.
+static constexpr double spinMs = 0.2;
+// Safety margin between the estimated end of a frame and the vertical blank in RenderLate mode.
+static constexpr double renderLateMarginMs = 1.5;
+
+static std::chrono::steady_clock::duration toDuration(double ms) {
+    using namespace std::chrono;
+    return duration_cast<steady_clock::duration>(duration<double, std::milli>(ms));
+}
+
+FramePacer::FramePacer(Mode mode, double targetFps)
+    : mode_(mode),
+      targetFps_(60.0),
+      refreshRate_(60.0),
+      workEstimateMs_(0.0),
+      overshootMs_(0.0),
+      lastWaitMs_(0.0) {
+    setTargetFps(targetFps);
+    nextFrame_ = clock::now();
+    frameStart_ = nextFrame_;
+    lastSwap_ = nextFrame_;
+}
+
+void FramePacer::setMode(Mode mode) {
+    mode_ = mode;
+    nextFrame_ = clock::now();
+}
+
+void FramePacer::setTargetFps(double fps) {
+    if (!(fps > 0.0)) {
+        throw std::invalid_argument("Target frame rate must be greater than zero!");
+    }
+    targetFps_ = fps;
+}
+
+void FramePacer::setRefreshRate(double hz) {
+    if (hz > 0.0) {
+        refreshRate_ = hz;
+    }
+}
+
+void FramePacer::wait() {
+    const auto waitStart = clock::now();
+    if (mode_ == Mode::Capped) {
+        const auto period = toDuration(1000.0 / targetFps_);
+        nextFrame_ += period;
+        // Do not try to catch up after a long frame, this would render a burst of frames.
+        if (nextFrame_ < waitStart - period) {
+            nextFrame_ = waitStart;
+        }
+        sleepUntil(nextFrame_);
+    } else if (mode_ == Mode::RenderLate) {
+        // The previous swap returned at about the last vertical blank, start late enough to finish just before the
+        // next one.
+        const double delayMs = 1000.0 / refreshRate_ - workEstimateMs_ - renderLateMarginMs;
+        if (delayMs > 0.0) {
+            sleepUntil(lastSwap_ + toDuration(delayMs));
+        }
+    }
+    frameStart_ = clock::now();
+    lastWaitMs_ = std::chrono::duration<double, std::milli>(frameStart_ - waitStart).count();
+}
+
+void FramePacer::beginSwap() {
+    const double workMs = std::chrono::duration<double, std::milli>(clock::now() - frameStart_).count();
+    // Follow longer frames immediately, shorter frames slowly, to avoid missing the vertical blank.
+    workEstimateMs_ = workMs > workEstimateMs_ ? workMs : 0.95 * workEstimateMs_ + 0.05 * workMs;
+}
+
+void FramePacer::endSwap() {
+    lastSwap_ = clock::now();
+}
+
+void FramePacer::sleepUntil(clock::time_point deadline) {
+    auto now = clock::now();
+    const auto sleepDuration = deadline - now - toDuration(overshootMs_ + spinMs);
+    if (sleepDuration > clock::duration::zero()) {
+        const auto expectedWakeup = now + sleepDuration;
+        std::this_thread::sleep_for(sleepDuration);
+        // Adapt to the timer resolution of the OS.
+        now = clock::now();
+        const double overshootMs = std::chrono::duration<double, std::milli>(now - expectedWakeup).count();
+        overshootMs_ = std::clamp(0.9 * overshootMs_ + 0.1 * overshootMs, 0.0, 20.0);
+    }
+    while (now < deadline) {
+        std::this_thread::yield();
+        now = clock::now();
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+
+namespace OGL4Core2::Core {
+    /**
+     * Controls when frames are started and submitted. The pacer itself is independent of GLFW, the caller has to
+     * apply swapInterval() to the context and to report the buffer swaps.
+     *
+     * Modes:
+     *   VSync:      Swap interval 1, the driver blocks until the next vertical blank.
+     *   Uncapped:   Swap interval 0, frames are rendered as fast as possible.
+     *   Capped:     Swap interval 0, frames are started at a fixed rate. The pacer sleeps most of the remaining
+     *               time and spins for the rest. The oversleep of the OS is measured and subtracted from the next
+     *               sleep.
+     *   RenderLate: Swap interval 1, but the start of a frame is delayed, so that it is finished shortly before the
+     *               next vertical blank. This minimizes the latency between input and display. The duration of a
+     *               frame is estimated from previous frames.
+     */
+    class FramePacer {
+    public:
+        enum class Mode {
+            VSync,
+            Uncapped,
+            Capped,
+            RenderLate,
+        };
+
+        explicit FramePacer(Mode mode = Mode::VSync, double targetFps = 60.0);
+        ~FramePacer() = default;
+
+        void setMode(Mode mode);
+        [[nodiscard]] inline Mode mode() const {
+            return mode_;
+        }
+
+        void setTargetFps(double fps);
+        [[nodiscard]] inline double targetFps() const {
+            return targetFps_;
+        }
+
+        /**
+         * Display refresh rate, used as frame rate in RenderLate mode.
+         *
+         * @param hz
+         */
+        void setRefreshRate(double hz);
+
+        [[nodiscard]] inline int swapInterval() const {
+            return (mode_ == Mode::VSync || mode_ == Mode::RenderLate) ? 1 : 0;
+        }
+
+        /**
+         * Wait until the next frame should be started. Call before processing input and rendering a frame.
+         */
+        void wait();
+
+        /**
+         * Call right before the buffer swap, i.e., when the CPU work of the frame is done.
+         */
+        void beginSwap();
+
+        /**
+         * Call right after the buffer swap returned.
+         */
+        void endSwap();
+
+        [[nodiscard]] inline double lastWaitMs() const {
+            return lastWaitMs_;
+        }
+        [[nodiscard]] inline double frameWorkEstimateMs() const {
+            return workEstimateMs_;
+        }
+        [[nodiscard]] inline double sleepOvershootMs() const {
+            return overshootMs_;
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        void sleepUntil(clock::time_point deadline);
+
+        Mode mode_;
+        double targetFps_;
+        double refreshRate_;
+
+        clock::time_point nextFrame_; // Capped mode deadline.
+        clock::time_point frameStart_;
+        clock::time_point lastSwap_;
+        double workEstimateMs_;
+        double overshootMs_;
+        double lastWaitMs_;
+    };
+} // namespace OGL4Core2::Core
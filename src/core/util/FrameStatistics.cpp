@@ -0,0 +1,171 @@
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace OGL4Core2::Core;
+
+// Histogram range, frame times outside are counted in the first or last bucket.
+static constexpr double histogramMinMs = 0.05;
+static constexpr double histogramMaxMs = 2000.0;
+
+FrameStatistics::FrameStatistics(std::size_t windowSize, double updateInterval, double spikeFactor)
+    : next_(0),
+      count_(0),
+      numSamples_(0),
+      sum_(0.0),
+      sumSquares_(0.0),
+      histogram_{},
+      spikeFactor_(spikeFactor),
+      lastIsSpike_(false),
+      spikeCount_(0),
+      updateInterval_(updateInterval),
+      formatBuffer_{} {
+    if (windowSize == 0) {
+        throw std::invalid_argument("Frame statistics window size must be greater than zero!");
+    }
+    times_.resize(windowSize, 0.0f);
+    minQueue_.indices.resize(windowSize);
+    maxQueue_.indices.resize(windowSize);
+    lastTick_ = std::chrono::steady_clock::now();
+    lastUpdate_ = lastTick_;
+}
+
+bool FrameStatistics::tick() {
+    const auto now = std::chrono::steady_clock::now();
+    addFrameTime(std::chrono::duration<double, std::milli>(now - lastTick_).count());
+    lastTick_ = now;
+    if (std::chrono::duration<double>(now - lastUpdate_).count() >= updateInterval_) {
+        lastUpdate_ = now;
+        return true;
+    }
+    return false;
+}
+
+void FrameStatistics::addFrameTime(double ms) {
+    // Spike detection compares against the window before adding the new frame.
+    lastIsSpike_ = count_ > 0 && ms > spikeFactor_ * percentile(50.0);
+    if (lastIsSpike_) {
+        spikeCount_++;
+    }
+
+    const uint64_t index = numSamples_++;
+    if (count_ == times_.size()) {
+        // Remove the oldest frame, which is overwritten now.
+        const float oldest = times_[next_];
+        sum_ -= oldest;
+        sumSquares_ -= static_cast<double>(oldest) * oldest;
+        histogram_[bucket(oldest)]--;
+        popMonotonic(minQueue_, index - times_.size());
+        popMonotonic(maxQueue_, index - times_.size());
+    } else {
+        count_++;
+    }
+    // All statistics use the stored float value, so removing it later exactly reverts adding it.
+    const float value = static_cast<float>(ms);
+    times_[next_] = value;
+    next_ = (next_ + 1) % times_.size();
+    sum_ += value;
+    sumSquares_ += static_cast<double>(value) * value;
+    histogram_[bucket(value)]++;
+    pushMonotonic(minQueue_, index, [](float a, float b) { return a <= b; });
+    pushMonotonic(maxQueue_, index, [](float a, float b) { return a >= b; });
+}
+
+void FrameStatistics::reset() {
+    std::fill(times_.begin(), times_.end(), 0.0f);
+    next_ = 0;
+    count_ = 0;
+    numSamples_ = 0;
+    sum_ = 0.0;
+    sumSquares_ = 0.0;
+    minQueue_.head = minQueue_.size = 0;
+    maxQueue_.head = maxQueue_.size = 0;
+    histogram_.fill(0);
+    lastIsSpike_ = false;
+    spikeCount_ = 0;
+    lastTick_ = std::chrono::steady_clock::now();
+}
+
+void FrameStatistics::restart() {
+    lastTick_ = std::chrono::steady_clock::now();
+}
+
+double FrameStatistics::min() const {
+    return minQueue_.size > 0 ? sample(minQueue_.indices[minQueue_.head]) : 0.0;
+}
+
+double FrameStatistics::max() const {
+    return maxQueue_.size > 0 ? sample(maxQueue_.indices[maxQueue_.head]) : 0.0;
+}
+
+double FrameStatistics::stddev() const {
+    if (count_ < 2) {
+        return 0.0;
+    }
+    const double n = static_cast<double>(count_);
+    const double variance = (sumSquares_ - sum_ * sum_ / n) / (n - 1.0);
+    return std::sqrt(std::max(variance, 0.0));
+}
+
+double FrameStatistics::percentile(double p) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    const double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(count_);
+    double cumulative = 0.0;
+    for (std::size_t i = 0; i < numBuckets; i++) {
+        const auto n = static_cast<double>(histogram_[i]);
+        if (n > 0.0 && cumulative + n >= rank) {
+            // Interpolate within the bucket, the result is limited to the exact min and max.
+            const double t = (rank - cumulative) / n;
+            const double value = bucketBegin(i) * std::pow(bucketBegin(i + 1) / bucketBegin(i), t);
+            return std::clamp(value, min(), max());
+        }
+        cumulative += n;
+    }
+    return max();
+}
+
+const char* FrameStatistics::format() {
+    std::snprintf(formatBuffer_.data(), formatBuffer_.size(), "%.2f FPS / %.2f ms", fps(), mean());
+    return formatBuffer_.data();
+}
+
+template<typename Compare>
+void FrameStatistics::pushMonotonic(MonotonicQueue& queue, uint64_t index, Compare compare) {
+    // Remove all samples from the back, which can never become the front, because the new one is better and newer.
+    const std::size_t capacity = queue.indices.size();
+    const float value = sample(index);
+    while (queue.size > 0 && compare(value, sample(queue.indices[(queue.head + queue.size - 1) % capacity]))) {
+        queue.size--;
+    }
+    queue.indices[(queue.head + queue.size) % capacity] = index;
+    queue.size++;
+}
+
+void FrameStatistics::popMonotonic(MonotonicQueue& queue, uint64_t expiredIndex) {
+    if (queue.size > 0 && queue.indices[queue.head] == expiredIndex) {
+        queue.head = (queue.head + 1) % queue.indices.size();
+        queue.size--;
+    }
+}
+
+float FrameStatistics::sample(uint64_t index) const {
+    return times_[static_cast<std::size_t>(index % times_.size())];
+}
+
+std::size_t FrameStatistics::bucket(double ms) {
+    if (!(ms > histogramMinMs)) {
+        return 0;
+    }
+    const double pos = std::log(ms / histogramMinMs) / std::log(histogramMaxMs / histogramMinMs);
+    return std::min(static_cast<std::size_t>(pos * static_cast<double>(numBuckets)), numBuckets - 1);
+}
+
+double FrameStatistics::bucketBegin(std::size_t bucket) {
+    return histogramMinMs *
+           std::pow(histogramMaxMs / histogramMinMs, static_cast<double>(bucket) / static_cast<double>(numBuckets));
+}
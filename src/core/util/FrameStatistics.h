@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OGL4Core2::Core {
+    /**
+     * Rolling statistics of the frame times of the last frames. Frame times are stored in a fixed-size ring, which
+     * can be plotted directly. Minimum and maximum are tracked with monotonic queues, mean and standard deviation with
+     * running sums, so each frame costs O(1). Percentiles are estimated from a log-scale histogram of the window
+     * (about 5 percent resolution). A frame is counted as spike if it takes more than spikeFactor times the median
+     * frame time.
+     *
+     * Nothing is allocated after construction, including format().
+     */
+    class FrameStatistics {
+    public:
+        /**
+         * @param windowSize Number of frames included in the statistics.
+         * @param updateInterval Interval in seconds, in which tick() returns true, i.e., to update a display.
+         * @param spikeFactor
+         */
+        explicit FrameStatistics(std::size_t windowSize = 240, double updateInterval = 1.0, double spikeFactor = 2.0);
+        ~FrameStatistics() = default;
+
+        /**
+         * Add the time since the previous tick as frame time.
+         *
+         * @return True once per update interval.
+         */
+        bool tick();
+
+        /**
+         * Add a frame time measured elsewhere.
+         *
+         * @param ms
+         */
+        void addFrameTime(double ms);
+
+        void reset();
+
+        /**
+         * Start measuring the next frame time at the current time, without adding the time since the previous tick,
+         * e.g., after the application was idle.
+         */
+        void restart();
+
+        [[nodiscard]] inline std::size_t count() const {
+            return count_;
+        }
+        [[nodiscard]] inline double last() const {
+            return count_ > 0 ? times_[(next_ + times_.size() - 1) % times_.size()] : 0.0;
+        }
+        [[nodiscard]] double min() const;
+        [[nodiscard]] double max() const;
+        [[nodiscard]] inline double mean() const {
+            return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0;
+        }
+        /**
+         * Standard deviation of the frame times, i.e., the frame pacing jitter.
+         */
+        [[nodiscard]] double stddev() const;
+        [[nodiscard]] inline double fps() const {
+            return sum_ > 0.0 ? 1000.0 * static_cast<double>(count_) / sum_ : 0.0;
+        }
+
+        /**
+         * Estimated percentile of the frame times in the window.
+         *
+         * @param p Percentile in range [0, 100].
+         * @return Frame time in milliseconds.
+         */
+        [[nodiscard]] double percentile(double p) const;
+
+        [[nodiscard]] inline bool isSpike() const {
+            return lastIsSpike_;
+        }
+        [[nodiscard]] inline uint64_t spikeCount() const {
+            return spikeCount_;
+        }
+
+        /**
+         * Frame times in milliseconds as ring buffer, the oldest frame is at plotOffset(). Intended for
+         * ImGui::PlotLines().
+         */
+        [[nodiscard]] inline const float* plotData() const {
+            return times_.data();
+        }
+        [[nodiscard]] inline int plotCount() const {
+            return static_cast<int>(times_.size());
+        }
+        [[nodiscard]] inline int plotOffset() const {
+            return static_cast<int>(next_);
+        }
+
+        /**
+         * Format "<fps> FPS / <mean> ms" into an internal buffer, valid until the next call.
+         */
+        const char* format();
+
+    private:
+        // Ring of sample indices with monotonic values, front is the min (or max) of the window.
+        struct MonotonicQueue {
+            std::vector<uint64_t> indices;
+            std::size_t head = 0;
+            std::size_t size = 0;
+        };
+
+        template<typename Compare>
+        void pushMonotonic(MonotonicQueue& queue, uint64_t index, Compare compare);
+        void popMonotonic(MonotonicQueue& queue, uint64_t expiredIndex);
+        [[nodiscard]] float sample(uint64_t index) const;
+
+        static std::size_t bucket(double ms);
+        static double bucketBegin(std::size_t bucket);
+
+        static constexpr std::size_t numBuckets = 200;
+
+        std::vector<float> times_;
+        std::size_t next_;
+        std::size_t count_;
+        uint64_t numSamples_; // Total number of samples, used as sample index.
+        double sum_;
+        double sumSquares_;
+        MonotonicQueue minQueue_;
+        MonotonicQueue maxQueue_;
+        std::array<uint32_t, numBuckets> histogram_;
+
+        double spikeFactor_;
+        bool lastIsSpike_;
+        uint64_t spikeCount_;
+
+        double updateInterval_;
+        std::chrono::steady_clock::time_point lastTick_;
+        std::chrono::steady_clock::time_point lastUpdate_;
+
+        std::array<char, 64> formatBuffer_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,62 @@
+#include "Framebuffer.h"
+
+#include <stdexcept>
+
+using namespace OGL4Core2::Core;
+
+Framebuffer::Framebuffer(int width, int height)
+    : fbo_(0),
+      color_(0),
+      depthStencil_(0),
+      width_(width),
+      height_(height) {
+    create();
+}
+
+Framebuffer::~Framebuffer() {
+    destroy();
+}
+
+void Framebuffer::resize(int width, int height) {
+    if (width == width_ && height == height_) {
+        return;
+    }
+    destroy();
+    width_ = width;
+    height_ = height;
+    create();
+}
+
+void Framebuffer::create() {
+    if (width_ <= 0 || height_ <= 0) {
+        throw std::invalid_argument("Invalid framebuffer size!");
+    }
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &color_);
+    glTextureStorage2D(color_, 1, GL_RGBA8, width_, height_);
+    glTextureParameteri(color_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(color_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(color_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(color_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glCreateRenderbuffers(1, &depthStencil_);
+    glNamedRenderbufferStorage(depthStencil_, GL_DEPTH24_STENCIL8, width_, height_);
+
+    glCreateFramebuffers(1, &fbo_);
+    glNamedFramebufferTexture(fbo_, GL_COLOR_ATTACHMENT0, color_, 0);
+    glNamedFramebufferRenderbuffer(fbo_, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil_);
+
+    if (glCheckNamedFramebufferStatus(fbo_, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        destroy();
+        throw std::runtime_error("Framebuffer is incomplete!");
+    }
+}
+
+void Framebuffer::destroy() {
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteRenderbuffers(1, &depthStencil_);
+    glDeleteTextures(1, &color_);
+    fbo_ = 0;
+    depthStencil_ = 0;
+    color_ = 0;
+}
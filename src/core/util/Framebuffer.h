@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glad/gl.h>
+
+namespace OGL4Core2::Core {
+    /**
+     * Offscreen framebuffer with a RGBA8 color texture and a depth/stencil renderbuffer, i.e., the same attachments as
+     * the default framebuffer of the window. Requires a current OpenGL context for all methods including destructor.
+     */
+    class Framebuffer {
+    public:
+        Framebuffer(int width, int height);
+        ~Framebuffer();
+
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer(Framebuffer&&) = delete;
+        Framebuffer& operator=(const Framebuffer&) = delete;
+        Framebuffer& operator=(Framebuffer&&) = delete;
+
+        /**
+         * Reallocate the attachments if the size changed. Content is undefined afterwards.
+         *
+         * @param width
+         * @param height
+         */
+        void resize(int width, int height);
+
+        [[nodiscard]] inline GLuint name() const {
+            return fbo_;
+        }
+        [[nodiscard]] inline GLuint colorTexture() const {
+            return color_;
+        }
+        [[nodiscard]] inline int width() const {
+            return width_;
+        }
+        [[nodiscard]] inline int height() const {
+            return height_;
+        }
+
+    private:
+        void create();
+        void destroy();
+
+        GLuint fbo_;
+        GLuint color_;
+        GLuint depthStencil_;
+        int width_;
+        int height_;
+    };
+} // namespace OGL4Core2::Core
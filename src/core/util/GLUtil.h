@@ -1,10 +1,13 @@
 #pragma once
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
 #include <glad/gl.h>
 
+#include "Image.h"
+
 #ifdef OGL4CORE2_ENABLE_STACKTRACE
 #include <boost/stacktrace.hpp>
 #endif
@@ -42,6 +45,41 @@ namespace OGL4Core2::Core {
 #endif
         }
 
+        /**
+         * Upload an RGBA image into a region of a 2D texture (or one layer of a 2D array texture), starting at the
+         * given texture row. Texture rows are in OpenGL order (bottom-up). A bottom-up view is uploaded with a single
+         * call. A top-down view is uploaded row by row in reversed order, this is only a fallback, use an UploadBuffer
+         * to upload top-down views with a single call.
+         *
+         * @param texture
+         * @param image
+         * @param level Mipmap level.
+         * @param layer Layer for array textures, -1 for 2D textures.
+         */
+        static void uploadImage(GLuint texture, const ImageView& image, GLint level = 0, GLint layer = -1) {
+            if (image.stride % static_cast<std::ptrdiff_t>(ImageView::pixelSize) != 0) {
+                throw std::runtime_error("Image stride must be a multiple of the pixel size!");
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(image.stride / ImageView::pixelSize));
+            auto upload = [&](int y, int h, const unsigned char* data) {
+                if (layer < 0) {
+                    glTextureSubImage2D(texture, level, 0, y, image.width, h, GL_RGBA, GL_UNSIGNED_BYTE, data);
+                } else {
+                    glTextureSubImage3D(texture, level, 0, y, layer, image.width, h, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                        data);
+                }
+            };
+            if (image.bottomUp) {
+                upload(0, image.height, image.data);
+            } else {
+                for (int y = 0; y < image.height; y++) {
+                    upload(y, 1, image.rowFromBottom(y));
+                }
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        }
+
     private:
         static std::string getSource(GLenum source) {
             switch (source) {
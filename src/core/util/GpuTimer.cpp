@@ -0,0 +1,146 @@
+#include "GpuTimer.h"
+
+#include <stdexcept>
+
+using namespace OGL4Core2::Core;
+
+GpuTimer::Scope::Scope(Scope&& other) noexcept : timer_(other.timer_) {
+    other.timer_ = nullptr;
+}
+
+GpuTimer::Scope::~Scope() {
+    if (timer_ != nullptr && timer_->isFrameActive()) {
+        timer_->end();
+    }
+}
+
+GpuTimer::GpuTimer(std::size_t latency) : first_(0), count_(0), frameActive_(false) {
+    if (latency == 0) {
+        throw std::invalid_argument("GPU timer latency must be greater than zero!");
+    }
+    slots_.resize(latency);
+}
+
+GpuTimer::~GpuTimer() {
+    for (auto& slot : slots_) {
+        glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+}
+
+void GpuTimer::beginFrame(uint64_t frameNumber) {
+    if (frameActive_) {
+        throw std::runtime_error("GPU timer frame is already active!");
+    }
+    // Ring is full, drop the oldest results instead of waiting for them.
+    if (count_ == slots_.size()) {
+        first_ = (first_ + 1) % slots_.size();
+        count_--;
+    }
+    count_++;
+    frameActive_ = true;
+
+    auto& slot = currentSlot();
+    slot.frameNumber = frameNumber;
+    slot.numQueries = 0;
+    slot.scopes.clear();
+    timestamp(slot);
+}
+
+void GpuTimer::endFrame() {
+    if (!frameActive_) {
+        throw std::runtime_error("GPU timer frame is not active!");
+    }
+    while (!openScopes_.empty()) {
+        end();
+    }
+    // The frame end is always the last query of a slot.
+    timestamp(currentSlot());
+    frameActive_ = false;
+}
+
+void GpuTimer::begin(const std::string& name) {
+    if (!frameActive_) {
+        return;
+    }
+    auto it = nameIndices_.find(name);
+    if (it == nameIndices_.end()) {
+        it = nameIndices_.emplace(name, names_.size()).first;
+        names_.push_back(name);
+    }
+    auto& slot = currentSlot();
+    const std::size_t query = timestamp(slot);
+    openScopes_.push_back(slot.scopes.size());
+    slot.scopes.push_back({it->second, static_cast<int>(openScopes_.size()) - 1, query, query});
+}
+
+void GpuTimer::end() {
+    if (!frameActive_) {
+        return;
+    }
+    if (openScopes_.empty()) {
+        throw std::runtime_error("GPU timer scope ended without begin!");
+    }
+    auto& slot = currentSlot();
+    slot.scopes[openScopes_.back()].end = timestamp(slot);
+    openScopes_.pop_back();
+}
+
+GpuTimer::Scope GpuTimer::scope(const std::string& name) {
+    if (!frameActive_) {
+        return Scope(nullptr);
+    }
+    begin(name);
+    return Scope(this);
+}
+
+bool GpuTimer::pop(Frame& frame, bool wait) {
+    // The currently measured frame cannot be collected.
+    if (count_ == 0 || (count_ == 1 && frameActive_)) {
+        return false;
+    }
+    auto& slot = slots_[first_];
+    // Timestamps complete in order, so the frame end tells if all queries of the slot are available.
+    const GLuint lastQuery = slot.queries[slot.numQueries - 1];
+    if (!wait) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            return false;
+        }
+    }
+    timestamps_.resize(slot.numQueries);
+    for (std::size_t i = 0; i < slot.numQueries; i++) {
+        glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &timestamps_[i]);
+    }
+    const auto elapsed = [&](std::size_t begin, std::size_t end) {
+        return static_cast<double>(timestamps_[end] - timestamps_[begin]) * 1.0e-6;
+    };
+
+    frame.frameNumber = slot.frameNumber;
+    frame.ms = elapsed(0, slot.numQueries - 1);
+    frame.begin = timestamps_[0];
+    frame.end = timestamps_[slot.numQueries - 1];
+    frame.scopes.resize(slot.scopes.size());
+    for (std::size_t i = 0; i < slot.scopes.size(); i++) {
+        const auto& scope = slot.scopes[i];
+        frame.scopes[i].name = names_[scope.nameIdx];
+        frame.scopes[i].depth = scope.depth;
+        frame.scopes[i].ms = elapsed(scope.begin, scope.end);
+        frame.scopes[i].begin = timestamps_[scope.begin];
+        frame.scopes[i].end = timestamps_[scope.end];
+    }
+
+    first_ = (first_ + 1) % slots_.size();
+    count_--;
+    return true;
+}
+
+std::size_t GpuTimer::timestamp(Slot& slot) {
+    if (slot.numQueries == slot.queries.size()) {
+        const std::size_t grow = slot.queries.empty() ? 16 : slot.queries.size();
+        slot.queries.resize(slot.queries.size() + grow);
+        glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(grow), slot.queries.data() + slot.numQueries);
+    }
+    glQueryCounter(slot.queries[slot.numQueries], GL_TIMESTAMP);
+    return slot.numQueries++;
+}
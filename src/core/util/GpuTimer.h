@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace OGL4Core2::Core {
+    /**
+     * Measures GPU times of whole frames and of named (nested) scopes within a frame using timestamp queries. The
+     * queries of each frame are kept in a ring of per-frame slots and the results are collected some frames later,
+     * when they are available, so measuring never stalls the pipeline. If results are not collected in time, the
+     * oldest frame is dropped.
+     *
+     * Scopes are only measured between beginFrame() and endFrame(), outside of a frame they are ignored. This way
+     * plugin code can always use scopes, even if it is rendered outside the regular frame, e.g., during a tiled
+     * screenshot.
+     *
+     * All methods, including the destructor, require the OpenGL context to be current.
+     */
+    class GpuTimer {
+    public:
+        struct Result {
+            std::string name;
+            int depth = 0; // Nesting level, 0 for top level scopes.
+            double ms = 0.0;
+            uint64_t begin = 0; // GPU timestamps in nanoseconds, see glGetInteger64v(GL_TIMESTAMP).
+            uint64_t end = 0;
+        };
+
+        struct Frame {
+            uint64_t frameNumber = 0;
+            double ms = 0.0; // Time of the whole frame.
+            uint64_t begin = 0;
+            uint64_t end = 0;
+            std::vector<Result> scopes; // In order of begin().
+        };
+
+        /**
+         * Ends the measurement of a named scope on destruction, see GpuTimer::scope().
+         */
+        class Scope {
+        public:
+            Scope(Scope&& other) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope& operator=(Scope&&) = delete;
+
+        private:
+            friend class GpuTimer;
+            explicit Scope(GpuTimer* timer) : timer_(timer) {}
+
+            GpuTimer* timer_;
+        };
+
+        /**
+         * @param latency Number of frames in flight, i.e., the ring size.
+         */
+        explicit GpuTimer(std::size_t latency = 4);
+        ~GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer(GpuTimer&&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+        GpuTimer& operator=(GpuTimer&&) = delete;
+
+        void beginFrame(uint64_t frameNumber);
+
+        /**
+         * End the frame, scopes still open are ended as well.
+         */
+        void endFrame();
+
+        void begin(const std::string& name);
+        void end();
+
+        /**
+         * Begin a named scope, which ends when the returned object is destroyed.
+         *
+         * @param name
+         * @return Scope
+         */
+        [[nodiscard]] Scope scope(const std::string& name);
+
+        /**
+         * Collect the results of the oldest measured frame.
+         *
+         * @param frame Output frame, the scope vector is reused.
+         * @param wait Block until the results are available, false is only returned if no frame is pending.
+         * @return bool
+         */
+        bool pop(Frame& frame, bool wait = false);
+
+        [[nodiscard]] inline bool isFrameActive() const {
+            return frameActive_;
+        }
+
+    private:
+        struct ScopeQueries {
+            std::size_t nameIdx;
+            int depth;
+            std::size_t begin; // Query indices within the slot.
+            std::size_t end;
+        };
+
+        struct Slot {
+            std::vector<GLuint> queries;
+            std::size_t numQueries = 0;
+            std::vector<ScopeQueries> scopes;
+            uint64_t frameNumber = 0;
+        };
+
+        std::size_t timestamp(Slot& slot);
+        [[nodiscard]] inline Slot& currentSlot() {
+            return slots_[(first_ + count_ - 1) % slots_.size()];
+        }
+
+        std::vector<Slot> slots_;
+        std::size_t first_; // Oldest pending slot.
+        std::size_t count_; // Number of pending slots, including the one currently measured.
+        bool frameActive_;
+        std::vector<std::size_t> openScopes_; // Indices into the scopes of the current slot.
+        std::vector<GLuint64> timestamps_;
+
+        // Scope names are stored once, slots only keep the index.
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, std::size_t> nameIndices_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace OGL4Core2::Core {
+    /**
+     * Non-owning view of an RGBA image with 8 bit per channel. The rows may be stored in top-down order (as in image
+     * files) or in bottom-up order (OpenGL convention) and may have a larger stride than the row size. Consumers
+     * iterate the rows in the order they need, so the pixel data never has to be flipped or repacked.
+     */
+    struct ImageView {
+        static constexpr std::size_t pixelSize = 4;
+
+        const unsigned char* data = nullptr; // First row in memory.
+        int width = 0;
+        int height = 0;
+        std::ptrdiff_t stride = 0; // Bytes between consecutive rows in memory.
+        bool bottomUp = false; // Memory row order.
+
+        ImageView() = default;
+        ImageView(const unsigned char* data, int width, int height, bool bottomUp, std::ptrdiff_t stride = 0)
+            : data(data),
+              width(width),
+              height(height),
+              stride(stride > 0 ? stride : static_cast<std::ptrdiff_t>(width) * pixelSize),
+              bottomUp(bottomUp) {}
+
+        [[nodiscard]] inline std::size_t rowSize() const {
+            return static_cast<std::size_t>(width) * pixelSize;
+        }
+
+        [[nodiscard]] inline bool isPacked() const {
+            return stride == static_cast<std::ptrdiff_t>(rowSize());
+        }
+
+        /**
+         * Row y counted from the top of the image.
+         */
+        [[nodiscard]] inline const unsigned char* row(int y) const {
+            return data + static_cast<std::ptrdiff_t>(bottomUp ? height - 1 - y : y) * stride;
+        }
+
+        /**
+         * Row y counted from the bottom of the image, i.e., OpenGL texture row y.
+         */
+        [[nodiscard]] inline const unsigned char* rowFromBottom(int y) const {
+            return row(height - 1 - y);
+        }
+
+        /**
+         * Sub view of count rows, starting at row first counted from the top of the image.
+         */
+        [[nodiscard]] inline ImageView rows(int first, int count) const {
+            const int memFirst = bottomUp ? height - first - count : first;
+            return ImageView(data + static_cast<std::ptrdiff_t>(memFirst) * stride, width, count, bottomUp, stride);
+        }
+    };
+
+    /**
+     * RGBA image owning its pixel data, see ImageView for the layout.
+     */
+    struct Image {
+        std::vector<unsigned char> pixels;
+        int width = 0;
+        int height = 0;
+        bool bottomUp = false;
+
+        [[nodiscard]] inline ImageView view() const {
+            return ImageView(pixels.data(), width, height, bottomUp);
+        }
+    };
+} // namespace OGL4Core2::Core
@@ -21,32 +21,54 @@ namespace {
     }
 } // namespace
 
-std::vector<unsigned char> ImageUtil::loadPngImage(const std::filesystem::path& filename, int& width, int& height) {
-    std::vector<unsigned char> image;
+Image ImageUtil::loadPngImage(const std::filesystem::path& filename) {
+    Image image;
     unsigned int w, h;
-    unsigned int error = lodepng::decode(image, w, h, filename.string());
+    unsigned int error = lodepng::decode(image.pixels, w, h, filename.string());
     if (error != 0) {
         std::string errorText = lodepng_error_text(error);
         throw std::runtime_error("Cannot load PNG image: " + errorText);
     }
-    width = static_cast<int>(w);
-    height = static_cast<int>(h);
-
-    flipImage(image, width, height, 4);
+    image.width = static_cast<int>(w);
+    image.height = static_cast<int>(h);
+    image.bottomUp = false;
+    return image;
+}
 
+Image ImageUtil::decodePngImage(const std::vector<unsigned char>& png) {
+    Image image;
+    unsigned int w, h;
+    unsigned int error = lodepng::decode(image.pixels, w, h, png);
+    if (error != 0) {
+        std::string errorText = lodepng_error_text(error);
+        throw std::runtime_error("Cannot decode PNG image: " + errorText);
+    }
+    image.width = static_cast<int>(w);
+    image.height = static_cast<int>(h);
+    image.bottomUp = false;
     return image;
 }
 
+std::vector<unsigned char> ImageUtil::loadPngImage(const std::filesystem::path& filename, int& width, int& height) {
+    Image image = loadPngImage(filename);
+    width = image.width;
+    height = image.height;
+
+    flipImage(image.pixels, width, height, 4);
+
+    return std::move(image.pixels);
+}
+
+void ImageUtil::savePngImage(const std::filesystem::path& filename, const ImageView& image, int level) {
+    PngWriter png(filename, image.width, image.height, level);
+    png.writeRows(image);
+    png.finish();
+}
+
 void ImageUtil::savePngImage(const std::filesystem::path& filename, std::vector<unsigned char>&& image, int width,
-    int height) {
-    flipImage(image, width, height, 4);
-
-    std::vector<unsigned char> png;
-    auto error = lodepng::encode(png, image, static_cast<unsigned int>(width), static_cast<unsigned int>(height));
-    if (error == 0) {
-        lodepng::save_file(png, filename.string());
-    } else {
-        std::string errorText = lodepng_error_text(error);
-        throw std::runtime_error("Cannot write PNG image: " + errorText);
+    int height, int level) {
+    if (image.size() != static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * ImageView::pixelSize) {
+        throw std::runtime_error("Invalid image size!");
     }
+    savePngImage(filename, ImageView(image.data(), width, height, true), level);
 }
@@ -3,12 +3,36 @@
 #include <filesystem>
 #include <vector>
 
+#include "Image.h"
+#include "PngWriter.h"
+
 namespace OGL4Core2::Core {
     class ImageUtil {
     public:
+        /**
+         * Load a PNG image as RGBA. The rows are returned in file order (top-down), use the view to access them in
+         * any order.
+         */
+        static Image loadPngImage(const std::filesystem::path& filename);
+
+        /**
+         * Decode a PNG image from memory as RGBA, see loadPngImage().
+         */
+        static Image decodePngImage(const std::vector<unsigned char>& png);
+
+        /**
+         * Load a PNG image as RGBA buffer in OpenGL row order (bottom-up). Prefer the overload above, this one needs
+         * to flip the decoded image.
+         */
         static std::vector<unsigned char> loadPngImage(const std::filesystem::path& filename, int& width, int& height);
 
+        static void savePngImage(const std::filesystem::path& filename, const ImageView& image,
+            int level = PngWriter::defaultLevel);
+
+        /**
+         * Save a RGBA buffer in OpenGL row order (bottom-up), i.e., as returned by glReadPixels.
+         */
         static void savePngImage(const std::filesystem::path& filename, std::vector<unsigned char>&& image, int width,
-            int height);
+            int height, int level = PngWriter::defaultLevel);
     };
 } // namespace OGL4Core2::Core
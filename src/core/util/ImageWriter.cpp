@@ -0,0 +1,87 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ImageUtil.h"
+#include "Profiler.h"
+
+using namespace OGL4Core2::Core;
+
+ImageWriter::ImageWriter(std::size_t numThreads, std::size_t maxQueueSize)
+    : maxQueueSize_(maxQueueSize),
+      activeJobs_(0),
+      stop_(false) {
+    if (maxQueueSize_ == 0) {
+        throw std::invalid_argument("Image writer queue size must be greater than zero!");
+    }
+    if (numThreads == 0) {
+        // Leave some threads for rendering.
+        numThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    threads_.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; i++) {
+        threads_.emplace_back(&ImageWriter::worker, this);
+    }
+}
+
+ImageWriter::~ImageWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    jobAvailable_.notify_all();
+    // Workers finish the remaining queue before they exit.
+    for (auto& t : threads_) {
+        t.join();
+    }
+}
+
+void ImageWriter::savePngImage(const std::filesystem::path& filename, std::vector<unsigned char>&& image, int width,
+    int height, int level) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queueNotFull_.wait(lock, [this] { return queue_.size() < maxQueueSize_; });
+        queue_.push_back(Job{filename, std::move(image), width, height, level});
+    }
+    jobAvailable_.notify_one();
+}
+
+void ImageWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && activeJobs_ == 0; });
+}
+
+void ImageWriter::worker() {
+    Profiler::setThreadName("ImageWriter");
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobAvailable_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            activeJobs_++;
+        }
+        queueNotFull_.notify_one();
+
+        try {
+            OGL4CORE2_PROFILE_ZONE("ImageWriter job");
+            ImageUtil::savePngImage(job.filename, std::move(job.image), job.width, job.height, job.level);
+        } catch (const std::exception& ex) {
+            std::cerr << "Cannot write image \"" << job.filename.string() << "\": " << ex.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            activeJobs_--;
+        }
+        idle_.notify_all();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PngWriter.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Worker pool to encode and write PNG images in the background. Jobs take ownership of the pixel data. The job
+     * queue is bounded, if it is full, savePngImage() blocks until a worker picks up the next job. This limits the
+     * memory held by queued images when capturing faster than the workers can encode.
+     */
+    class ImageWriter {
+    public:
+        /**
+         * @param numThreads Number of worker threads, 0 selects a number based on the available hardware threads.
+         * @param maxQueueSize Maximum number of queued images not yet picked up by a worker.
+         */
+        explicit ImageWriter(std::size_t numThreads = 0, std::size_t maxQueueSize = 8);
+        ~ImageWriter();
+
+        ImageWriter(const ImageWriter&) = delete;
+        ImageWriter(ImageWriter&&) = delete;
+        ImageWriter& operator=(const ImageWriter&) = delete;
+        ImageWriter& operator=(ImageWriter&&) = delete;
+
+        /**
+         * Queue an image for writing, see ImageUtil::savePngImage() for the parameters, the image is expected in
+         * OpenGL row order (bottom-up). Errors during encoding or writing are reported to std::cerr, as they happen on
+         * a worker thread.
+         */
+        void savePngImage(const std::filesystem::path& filename, std::vector<unsigned char>&& image, int width,
+            int height, int level = PngWriter::defaultLevel);
+
+        /**
+         * Block until all queued images are written.
+         */
+        void flush();
+
+    private:
+        struct Job {
+            std::filesystem::path filename;
+            std::vector<unsigned char> image;
+            int width;
+            int height;
+            int level;
+        };
+
+        void worker();
+
+        std::size_t maxQueueSize_;
+        std::deque<Job> queue_;
+        std::size_t activeJobs_;
+        bool stop_;
+        std::mutex mutex_;
+        std::condition_variable jobAvailable_;
+        std::condition_variable queueNotFull_;
+        std::condition_variable idle_;
+        std::vector<std::thread> threads_;
+    };
+} // namespace OGL4Core2::Core
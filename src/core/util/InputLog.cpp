@@ -0,0 +1,194 @@
+#include "InputLog.h"
+
+#include <array>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+// clang-format off
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    // Binary log: magic and version, int32 window width and height, followed by records starting with the type byte
+    // and the uint32 number of frames since the previous event. All values are stored in native byte order.
+    //   Key:         int32 key, int32 scancode, uint8 action, uint8 mods
+    //   Char:        uint32 codepoint
+    //   MouseButton: uint8 button, uint8 action, uint8 mods
+    //   MouseMove:   double x, double y
+    //   MouseScroll: double x, double y
+    constexpr std::array<char, 8> binaryMagic{'O', 'G', 'L', '4', 'I', 'N', 'P', 'T'};
+    constexpr uint32_t binaryVersion = 1;
+
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool readValue(std::istream& is, T& value) {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readByte(std::istream& is, int& value) {
+        uint8_t byte = 0;
+        if (!readValue(is, byte)) {
+            return false;
+        }
+        value = byte;
+        return true;
+    }
+} // namespace
+
+InputRecorder::InputRecorder(const std::filesystem::path& filename, int windowWidth, int windowHeight)
+    : file_(filename, std::ios::binary),
+      lastFrameNumber_(0),
+      numEvents_(0) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + filename.string() + "\"!");
+    }
+    file_.write(binaryMagic.data(), binaryMagic.size());
+    writeValue(file_, binaryVersion);
+    writeValue(file_, static_cast<int32_t>(windowWidth));
+    writeValue(file_, static_cast<int32_t>(windowHeight));
+}
+
+void InputRecorder::add(const InputEvent& event) {
+    if (event.frameNumber < lastFrameNumber_ ||
+        event.frameNumber - lastFrameNumber_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Invalid frame number of input event!");
+    }
+    writeValue(file_, event.type);
+    writeValue(file_, static_cast<uint32_t>(event.frameNumber - lastFrameNumber_));
+    switch (event.type) {
+        case InputEvent::Type::Key:
+            writeValue(file_, static_cast<int32_t>(event.code));
+            writeValue(file_, static_cast<int32_t>(event.scancode));
+            writeValue(file_, static_cast<uint8_t>(event.action));
+            writeValue(file_, static_cast<uint8_t>(event.mods));
+            break;
+        case InputEvent::Type::Char:
+            writeValue(file_, static_cast<uint32_t>(event.code));
+            break;
+        case InputEvent::Type::MouseButton:
+            writeValue(file_, static_cast<uint8_t>(event.code));
+            writeValue(file_, static_cast<uint8_t>(event.action));
+            writeValue(file_, static_cast<uint8_t>(event.mods));
+            break;
+        case InputEvent::Type::MouseMove:
+        case InputEvent::Type::MouseScroll:
+            writeValue(file_, event.x);
+            writeValue(file_, event.y);
+            break;
+    }
+    lastFrameNumber_ = event.frameNumber;
+    numEvents_++;
+}
+
+InputPlayer::InputPlayer(const std::filesystem::path& filename)
+    : pos_(0),
+      windowWidth_(0),
+      windowHeight_(0),
+      keys_(GLFW_KEY_LAST + 1, false),
+      mouseButtons_(GLFW_MOUSE_BUTTON_LAST + 1, false),
+      mouseX_(0.0),
+      mouseY_(0.0) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + filename.string() + "\"!");
+    }
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    in.read(magic.data(), magic.size());
+    if (!in || magic != binaryMagic || !readValue(in, version) || version != binaryVersion ||
+        !readValue(in, width) || !readValue(in, height)) {
+        throw std::runtime_error("Invalid input log: \"" + filename.string() + "\"!");
+    }
+    windowWidth_ = width;
+    windowHeight_ = height;
+
+    uint64_t frameNumber = 0;
+    InputEvent::Type type{};
+    while (readValue(in, type)) {
+        uint32_t frameDelta = 0;
+        bool valid = readValue(in, frameDelta);
+        frameNumber += frameDelta;
+        InputEvent event;
+        event.frameNumber = frameNumber;
+        event.type = type;
+        switch (type) {
+            case InputEvent::Type::Key: {
+                int32_t key = 0;
+                int32_t scancode = 0;
+                valid = valid && readValue(in, key) && readValue(in, scancode) && readByte(in, event.action) &&
+                        readByte(in, event.mods);
+                event.code = key;
+                event.scancode = scancode;
+                break;
+            }
+            case InputEvent::Type::Char: {
+                uint32_t codepoint = 0;
+                valid = valid && readValue(in, codepoint);
+                event.code = static_cast<int>(codepoint);
+                break;
+            }
+            case InputEvent::Type::MouseButton:
+                valid = valid && readByte(in, event.code) && readByte(in, event.action) && readByte(in, event.mods);
+                break;
+            case InputEvent::Type::MouseMove:
+            case InputEvent::Type::MouseScroll:
+                valid = valid && readValue(in, event.x) && readValue(in, event.y);
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid) {
+            throw std::runtime_error("Corrupt input log: \"" + filename.string() + "\"!");
+        }
+        events_.push_back(event);
+    }
+}
+
+bool InputPlayer::next(uint64_t frameNumber, InputEvent& event) {
+    if (finished() || events_[pos_].frameNumber > frameNumber) {
+        return false;
+    }
+    event = events_[pos_++];
+    // GLFW reports key repeats as separate action, the key stays pressed.
+    if (event.type == InputEvent::Type::Key && event.code >= 0 && event.code <= GLFW_KEY_LAST) {
+        keys_[event.code] = event.action != GLFW_RELEASE;
+    } else if (event.type == InputEvent::Type::MouseButton && event.code >= 0 && event.code <= GLFW_MOUSE_BUTTON_LAST) {
+        mouseButtons_[event.code] = event.action == GLFW_PRESS;
+    } else if (event.type == InputEvent::Type::MouseMove) {
+        mouseX_ = event.x;
+        mouseY_ = event.y;
+    }
+    return true;
+}
+
+bool InputPlayer::isKeyPressed(int key) const {
+    return key >= 0 && key <= GLFW_KEY_LAST && keys_[key];
+}
+
+bool InputPlayer::isMouseButtonPressed(int button) const {
+    return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && mouseButtons_[button];
+}
+
+bool InputPlayer::anyModKeyPressed() const {
+    return isKeyPressed(GLFW_KEY_LEFT_SHIFT) || isKeyPressed(GLFW_KEY_RIGHT_SHIFT) ||
+           isKeyPressed(GLFW_KEY_LEFT_CONTROL) || isKeyPressed(GLFW_KEY_RIGHT_CONTROL) ||
+           isKeyPressed(GLFW_KEY_LEFT_ALT) || isKeyPressed(GLFW_KEY_RIGHT_ALT) || isKeyPressed(GLFW_KEY_LEFT_SUPER) ||
+           isKeyPressed(GLFW_KEY_RIGHT_SUPER);
+}
+
+void InputPlayer::getMousePos(double& xpos, double& ypos) const {
+    xpos = mouseX_;
+    ypos = mouseY_;
+}
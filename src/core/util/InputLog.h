@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace OGL4Core2::Core {
+    /**
+     * Raw GLFW input event, as passed to the GLFW callbacks. Mouse positions are in window coordinates.
+     */
+    struct InputEvent {
+        enum class Type : uint8_t {
+            Key = 1,
+            Char = 2,
+            MouseButton = 3,
+            MouseMove = 4,
+            MouseScroll = 5,
+        };
+
+        uint64_t frameNumber = 0; // Last frame rendered before the event was received.
+        Type type = Type::Key;
+        int code = 0; // Key, codepoint or mouse button.
+        int scancode = 0;
+        int action = 0;
+        int mods = 0;
+        double x = 0.0; // Mouse position or scroll offset.
+        double y = 0.0;
+
+        static InputEvent key(int key, int scancode, int action, int mods) {
+            return {0, Type::Key, key, scancode, action, mods, 0.0, 0.0};
+        }
+        static InputEvent character(unsigned int codepoint) {
+            return {0, Type::Char, static_cast<int>(codepoint), 0, 0, 0, 0.0, 0.0};
+        }
+        static InputEvent mouseButton(int button, int action, int mods) {
+            return {0, Type::MouseButton, button, 0, action, mods, 0.0, 0.0};
+        }
+        static InputEvent mouseMove(double xpos, double ypos) {
+            return {0, Type::MouseMove, 0, 0, 0, 0, xpos, ypos};
+        }
+        static InputEvent mouseScroll(double xoffset, double yoffset) {
+            return {0, Type::MouseScroll, 0, 0, 0, 0, xoffset, yoffset};
+        }
+    };
+
+    /**
+     * Streams input events into a compact binary log, which is replayed with InputPlayer. The log starts with the
+     * window size, because mouse positions are only meaningful for the same size. Each event is stored with the
+     * number of frames since the previous event and only the fields used by its type.
+     */
+    class InputRecorder {
+    public:
+        /**
+         * @param filename
+         * @param windowWidth
+         * @param windowHeight
+         */
+        InputRecorder(const std::filesystem::path& filename, int windowWidth, int windowHeight);
+        ~InputRecorder() = default;
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder(InputRecorder&&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+        InputRecorder& operator=(InputRecorder&&) = delete;
+
+        /**
+         * @param event Event, the frame number must not be smaller than the one of the previous event.
+         */
+        void add(const InputEvent& event);
+
+        [[nodiscard]] inline std::size_t numEvents() const {
+            return numEvents_;
+        }
+
+    private:
+        std::ofstream file_;
+        uint64_t lastFrameNumber_;
+        std::size_t numEvents_;
+    };
+
+    /**
+     * Replays an input log written by InputRecorder. Events are returned frame by frame and the resulting key, mouse
+     * button and cursor state is tracked, to answer state queries consistent with the replayed events.
+     */
+    class InputPlayer {
+    public:
+        explicit InputPlayer(const std::filesystem::path& filename);
+        ~InputPlayer() = default;
+
+        /**
+         * Get the next event received up to the given frame.
+         *
+         * @param frameNumber
+         * @param event
+         * @return False if there are no more events up to this frame.
+         */
+        bool next(uint64_t frameNumber, InputEvent& event);
+
+        [[nodiscard]] inline bool finished() const {
+            return pos_ >= events_.size();
+        }
+        [[nodiscard]] inline std::size_t numEvents() const {
+            return events_.size();
+        }
+        [[nodiscard]] inline int windowWidth() const {
+            return windowWidth_;
+        }
+        [[nodiscard]] inline int windowHeight() const {
+            return windowHeight_;
+        }
+
+        [[nodiscard]] bool isKeyPressed(int key) const;
+        [[nodiscard]] bool isMouseButtonPressed(int button) const;
+        [[nodiscard]] bool anyModKeyPressed() const;
+        void getMousePos(double& xpos, double& ypos) const;
+
+    private:
+        std::vector<InputEvent> events_;
+        std::size_t pos_;
+        int windowWidth_;
+        int windowHeight_;
+
+        std::vector<bool> keys_;
+        std::vector<bool> mouseButtons_;
+        double mouseX_;
+        double mouseY_;
+    };
+} // namespace OGL4Core2::Core
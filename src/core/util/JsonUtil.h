@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace OGL4Core2::Core {
+    class JsonUtil {
+    public:
+        /**
+         * Escape a string to be written within quotes into a JSON file. Control characters are replaced by spaces.
+         *
+         * @param str
+         * @return escaped string
+         */
+        static std::string escape(const std::string& str) {
+            std::string result;
+            result.reserve(str.size());
+            for (const char c : str) {
+                if (c == '"' || c == '\\') {
+                    result += '\\';
+                    result += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    result += ' ';
+                } else {
+                    result += c;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Quote a string as a CSV field, so it may contain separators, quotes and line breaks. Quotes are doubled.
+         *
+         * @param str
+         * @return quoted field
+         */
+        static std::string csvField(const std::string& str) {
+            std::string result;
+            result.reserve(str.size() + 2);
+            result += '"';
+            for (const char c : str) {
+                if (c == '"') {
+                    result += '"';
+                }
+                result += c;
+            }
+            result += '"';
+            return result;
+        }
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,419 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <zlib.h>
+
+#include "Profiler.h"
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    constexpr std::size_t pixelSize = ImageView::pixelSize;
+    // Raw data per block, large enough that the sync flush overhead and the task overhead are negligible.
+    constexpr std::size_t targetBlockSize = 1024 * 1024;
+    constexpr std::size_t dictionarySize = 32 * 1024;
+
+    enum FilterType : unsigned char {
+        FilterNone = 0,
+        FilterSub = 1,
+        FilterUp = 2,
+        FilterAverage = 3,
+        FilterPaeth = 4,
+    };
+
+    /**
+     * Threads compressing the blocks of all PngWriter instances. Tasks are started in submission order, so a block
+     * always starts after the previous block of its image, whose filtered tail it waits for. This cannot deadlock, the
+     * previous block is already running and filtering does not wait for anything.
+     */
+    class BlockPool {
+    public:
+        static BlockPool& instance() {
+            static BlockPool pool;
+            return pool;
+        }
+
+        ~BlockPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            taskAvailable_.notify_all();
+            for (auto& t : threads_) {
+                t.join();
+            }
+        }
+
+        BlockPool(const BlockPool&) = delete;
+        BlockPool(BlockPool&&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+        BlockPool& operator=(BlockPool&&) = delete;
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(task));
+            }
+            taskAvailable_.notify_one();
+        }
+
+    private:
+        BlockPool() : stop_(false) {
+            const unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+            threads_.reserve(numThreads);
+            for (unsigned int i = 0; i < numThreads; i++) {
+                threads_.emplace_back(&BlockPool::worker, this);
+            }
+        }
+
+        void worker() {
+            Profiler::setThreadName("PngWriter");
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    taskAvailable_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                    if (queue_.empty()) {
+                        return;
+                    }
+                    task = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::deque<std::function<void()>> queue_;
+        bool stop_;
+        std::mutex mutex_;
+        std::condition_variable taskAvailable_;
+        std::vector<std::thread> threads_;
+    };
+
+    void writeUint32(unsigned char* dst, uint32_t v) {
+        dst[0] = static_cast<unsigned char>(v >> 24);
+        dst[1] = static_cast<unsigned char>(v >> 16);
+        dst[2] = static_cast<unsigned char>(v >> 8);
+        dst[3] = static_cast<unsigned char>(v);
+    }
+
+    unsigned char paethPredictor(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) {
+            return static_cast<unsigned char>(a);
+        }
+        return static_cast<unsigned char>(pb <= pc ? b : c);
+    }
+
+    // The filter loops are kept branch-free over plain byte arrays, so the compiler can vectorize None, Sub, Up and
+    // Average. Paeth is inherently serial per pixel.
+    void filterRow(FilterType type, const unsigned char* row, const unsigned char* prev, unsigned char* out,
+        std::size_t size) {
+        switch (type) {
+            case FilterNone:
+                std::memcpy(out, row, size);
+                break;
+            case FilterSub:
+                for (std::size_t i = 0; i < pixelSize; i++) {
+                    out[i] = row[i];
+                }
+                for (std::size_t i = pixelSize; i < size; i++) {
+                    out[i] = static_cast<unsigned char>(row[i] - row[i - pixelSize]);
+                }
+                break;
+            case FilterUp:
+                for (std::size_t i = 0; i < size; i++) {
+                    out[i] = static_cast<unsigned char>(row[i] - prev[i]);
+                }
+                break;
+            case FilterAverage:
+                for (std::size_t i = 0; i < pixelSize; i++) {
+                    out[i] = static_cast<unsigned char>(row[i] - (prev[i] >> 1));
+                }
+                for (std::size_t i = pixelSize; i < size; i++) {
+                    out[i] = static_cast<unsigned char>(row[i] - ((row[i - pixelSize] + prev[i]) >> 1));
+                }
+                break;
+            case FilterPaeth:
+                for (std::size_t i = 0; i < pixelSize; i++) {
+                    out[i] = static_cast<unsigned char>(row[i] - prev[i]);
+                }
+                for (std::size_t i = pixelSize; i < size; i++) {
+                    out[i] = static_cast<unsigned char>(
+                        row[i] - paethPredictor(row[i - pixelSize], prev[i], prev[i - pixelSize]));
+                }
+                break;
+        }
+    }
+
+    // Heuristic from the PNG specification: minimum sum of absolute differences, interpreting bytes as signed.
+    std::size_t filterCost(const unsigned char* data, std::size_t size) {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < size; i++) {
+            sum += static_cast<std::size_t>(std::abs(static_cast<int>(static_cast<signed char>(data[i]))));
+        }
+        return sum;
+    }
+
+    // Filter all rows of a block. Each output row is prefixed by its filter type byte.
+    std::vector<unsigned char> filterBlock(int level, const std::vector<unsigned char>& rows, int numRows,
+        const std::vector<unsigned char>& prevRow, std::size_t rowSize) {
+        std::vector<unsigned char> filtered(static_cast<std::size_t>(numRows) * (rowSize + 1));
+        std::vector<unsigned char> candidate;
+        if (level >= 4) {
+            candidate.resize(rowSize);
+        }
+        const unsigned char* prev = prevRow.data();
+        for (int y = 0; y < numRows; y++) {
+            const unsigned char* row = rows.data() + static_cast<std::size_t>(y) * rowSize;
+            unsigned char* out = filtered.data() + static_cast<std::size_t>(y) * (rowSize + 1);
+            if (level == 0) {
+                out[0] = FilterNone;
+                filterRow(FilterNone, row, prev, out + 1, rowSize);
+            } else if (level < 4) {
+                out[0] = FilterUp;
+                filterRow(FilterUp, row, prev, out + 1, rowSize);
+            } else {
+                std::size_t bestCost = std::numeric_limits<std::size_t>::max();
+                for (auto type : {FilterNone, FilterSub, FilterUp, FilterAverage, FilterPaeth}) {
+                    filterRow(type, row, prev, candidate.data(), rowSize);
+                    const std::size_t cost = filterCost(candidate.data(), rowSize);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        out[0] = type;
+                        std::memcpy(out + 1, candidate.data(), rowSize);
+                    }
+                }
+            }
+            prev = row;
+        }
+        return filtered;
+    }
+
+    std::vector<unsigned char> deflateBlock(int level, const std::vector<unsigned char>& data,
+        const std::vector<unsigned char>& dictionary, bool last) {
+        z_stream strm{};
+        int strategy = Z_DEFAULT_STRATEGY;
+        if (level >= 1 && level <= 3) {
+            strategy = Z_RLE;
+        } else if (level >= 4) {
+            strategy = Z_FILTERED;
+        }
+        // Negative window bits: raw deflate without zlib header, the header is written once for the whole stream.
+        if (deflateInit2(&strm, level, Z_DEFLATED, -15, 8, strategy) != Z_OK) {
+            throw std::runtime_error("Cannot initialize deflate stream!");
+        }
+        if (!dictionary.empty()) {
+            deflateSetDictionary(&strm, dictionary.data(), static_cast<uInt>(dictionary.size()));
+        }
+
+        // Bound is for Z_FINISH, add some space for the sync flush marker.
+        std::vector<unsigned char> out(deflateBound(&strm, static_cast<uLong>(data.size())) + 16);
+        strm.next_in = const_cast<Bytef*>(data.data());
+        strm.avail_in = static_cast<uInt>(data.size());
+        int ret;
+        do {
+            if (strm.total_out == out.size()) {
+                out.resize(out.size() * 2);
+            }
+            strm.next_out = out.data() + strm.total_out;
+            strm.avail_out = static_cast<uInt>(out.size() - strm.total_out);
+            ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+        } while (strm.avail_out == 0 || (last && ret == Z_OK));
+        out.resize(strm.total_out);
+        deflateEnd(&strm);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            throw std::runtime_error("Deflate failed!");
+        }
+        return out;
+    }
+} // namespace
+
+PngWriter::PngWriter(const std::filesystem::path& filename, int width, int height, int level,
+    unsigned int maxBlocksInFlight)
+    : width_(width),
+      height_(height),
+      level_(level),
+      maxBlocksInFlight_(
+          maxBlocksInFlight > 0 ? maxBlocksInFlight : std::max(1u, std::thread::hardware_concurrency())),
+      rowSize_(static_cast<std::size_t>(width) * pixelSize),
+      rowsPerBlock_(0),
+      rowsWritten_(0),
+      finished_(false),
+      blockNumRows_(0),
+      headerWritten_(false),
+      adler_(static_cast<uint32_t>(adler32(0L, Z_NULL, 0))) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Invalid PNG image size!");
+    }
+    if (level < 0 || level > 9) {
+        throw std::invalid_argument("Invalid PNG compression level!");
+    }
+    rowsPerBlock_ = static_cast<int>(std::max<std::size_t>(1, targetBlockSize / rowSize_));
+    blockRows_.resize(static_cast<std::size_t>(rowsPerBlock_) * rowSize_);
+    // Filters of the first row use a previous row of zeros.
+    prevRow_.assign(rowSize_, 0);
+    std::promise<std::vector<unsigned char>> emptyTail;
+    emptyTail.set_value({});
+    prevTail_ = emptyTail.get_future().share();
+
+    file_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open PNG file \"" + filename.string() + "\"!");
+    }
+
+    static constexpr unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file_.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::array<unsigned char, 13> ihdr{};
+    writeUint32(ihdr.data(), static_cast<uint32_t>(width_));
+    writeUint32(ihdr.data() + 4, static_cast<uint32_t>(height_));
+    ihdr[8] = 8; // bit depth
+    ihdr[9] = 6; // color type RGBA
+    ihdr[10] = 0; // compression method
+    ihdr[11] = 0; // filter method
+    ihdr[12] = 0; // interlace method
+    writeChunk("IHDR", ihdr.data(), ihdr.size());
+}
+
+PngWriter::~PngWriter() {
+    // Do not leave detached work behind if finish() was not called, i.e., due to an exception.
+    for (auto& f : blocksInFlight_) {
+        if (f.valid()) {
+            f.wait();
+        }
+    }
+}
+
+void PngWriter::writeRows(const ImageView& rows) {
+    if (rows.width != width_) {
+        throw std::runtime_error("Row width does not match PNG image!");
+    }
+    if (finished_ || rowsWritten_ + rows.height > height_) {
+        throw std::runtime_error("Too many rows written to PNG image!");
+    }
+    for (int y = 0; y < rows.height; y++) {
+        std::memcpy(blockRows_.data() + static_cast<std::size_t>(blockNumRows_) * rowSize_, rows.row(y), rowSize_);
+        blockNumRows_++;
+        rowsWritten_++;
+        if (blockNumRows_ == rowsPerBlock_ || rowsWritten_ == height_) {
+            submitBlock(rowsWritten_ == height_);
+        }
+    }
+}
+
+void PngWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    if (rowsWritten_ != height_) {
+        throw std::runtime_error("PNG image is incomplete!");
+    }
+    while (!blocksInFlight_.empty()) {
+        auto block = blocksInFlight_.front().get();
+        blocksInFlight_.pop_front();
+        writeBlock(std::move(block));
+    }
+    writeChunk("IEND", nullptr, 0);
+    file_.close();
+    if (file_.fail()) {
+        throw std::runtime_error("Cannot write PNG file!");
+    }
+    finished_ = true;
+}
+
+void PngWriter::submitBlock(bool last) {
+    // Back-pressure: bound the number of blocks held in memory.
+    while (blocksInFlight_.size() >= maxBlocksInFlight_) {
+        auto block = blocksInFlight_.front().get();
+        blocksInFlight_.pop_front();
+        writeBlock(std::move(block));
+    }
+
+    std::vector<unsigned char> rows(blockRows_.begin(),
+        blockRows_.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(blockNumRows_) * rowSize_));
+    std::vector<unsigned char> prevRow = prevRow_;
+    std::copy(rows.end() - static_cast<std::ptrdiff_t>(rowSize_), rows.end(), prevRow_.begin());
+
+    // The next block needs the tail of this block's filtered data as dictionary. It is passed on as soon as filtering
+    // is done, so compression of consecutive blocks still runs in parallel.
+    auto tailPromise = std::make_shared<std::promise<std::vector<unsigned char>>>();
+    auto prevTail = prevTail_;
+    prevTail_ = tailPromise->get_future().share();
+
+    auto task = std::make_shared<std::packaged_task<Block()>>(
+        [level = level_, rows = std::move(rows), numRows = blockNumRows_, prevRow = std::move(prevRow),
+            rowSize = rowSize_, tailPromise, prevTail, last]() {
+            OGL4CORE2_PROFILE_ZONE("PngWriter block");
+            Block block;
+            std::vector<unsigned char> filtered;
+            try {
+                filtered = filterBlock(level, rows, numRows, prevRow, rowSize);
+                const std::size_t tailSize = std::min(dictionarySize, filtered.size());
+                tailPromise->set_value(std::vector<unsigned char>(
+                    filtered.end() - static_cast<std::ptrdiff_t>(tailSize), filtered.end()));
+            } catch (...) {
+                tailPromise->set_exception(std::current_exception());
+                throw;
+            }
+            block.data = deflateBlock(level, filtered, prevTail.get(), last);
+            block.adler = static_cast<uint32_t>(
+                adler32(adler32(0L, Z_NULL, 0), filtered.data(), static_cast<uInt>(filtered.size())));
+            block.filteredSize = filtered.size();
+            block.last = last;
+            return block;
+        });
+    blocksInFlight_.emplace_back(task->get_future());
+    BlockPool::instance().submit([task]() { (*task)(); });
+    blockNumRows_ = 0;
+}
+
+void PngWriter::writeBlock(Block&& block) {
+    adler_ = static_cast<uint32_t>(adler32_combine(adler_, block.adler, static_cast<z_off_t>(block.filteredSize)));
+
+    if (!headerWritten_) {
+        // zlib header: deflate with 32K window, FLEVEL according to compression level, FCHECK makes it divisible by 31.
+        unsigned char flevel = (level_ <= 1) ? 0 : (level_ <= 5) ? 1 : (level_ == 6) ? 2 : 3;
+        unsigned int header = (0x78u << 8) | (static_cast<unsigned int>(flevel) << 6);
+        header += (31 - header % 31) % 31;
+        block.data.insert(block.data.begin(),
+            {static_cast<unsigned char>(header >> 8), static_cast<unsigned char>(header & 0xff)});
+        headerWritten_ = true;
+    }
+    if (block.last) {
+        // Last block, append adler32 checksum of the whole uncompressed stream.
+        const std::size_t pos = block.data.size();
+        block.data.resize(pos + 4);
+        writeUint32(block.data.data() + pos, adler_);
+    }
+    writeChunk("IDAT", block.data.data(), block.data.size());
+}
+
+void PngWriter::writeChunk(const char* type, const unsigned char* data, std::size_t size) {
+    unsigned char buf[4];
+    writeUint32(buf, static_cast<uint32_t>(size));
+    file_.write(reinterpret_cast<const char*>(buf), 4);
+    file_.write(type, 4);
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(type), 4);
+    if (size > 0) {
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    }
+    writeUint32(buf, static_cast<uint32_t>(crc));
+    file_.write(reinterpret_cast<const char*>(buf), 4);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "Image.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Streaming PNG encoder for RGBA images (8 bit per channel) with parallel compression. Rows are passed in top-down
+     * order in arbitrary portions and are collected into blocks. Each block is filtered and deflated as a task of a
+     * thread pool shared by all writers, using the tail of the previous block as preset dictionary. The pool has one
+     * thread per hardware thread, so writing several images at once, e.g., by the ImageWriter workers, does not
+     * oversubscribe the CPU. The non-final blocks are terminated with a sync flush,
+     * so the independent deflate streams can simply be concatenated into a single zlib stream (same approach as pigz).
+     * Finished blocks are written in order as IDAT chunks, therefore only a few blocks are held in memory at any time.
+     *
+     * The compression level trades size for speed:
+     *   0:   no filter, stored deflate blocks (fastest, largest).
+     *   1-3: Up filter and fast run-length deflate.
+     *   4-9: adaptive filter per row and deflate with the given zlib level.
+     */
+    class PngWriter {
+    public:
+        static constexpr int defaultLevel = 6;
+
+        /**
+         * @param filename
+         * @param width
+         * @param height
+         * @param level Compression level in range [0, 9].
+         * @param maxBlocksInFlight Maximum number of blocks submitted but not yet written, 0 uses the number of
+         *                          hardware threads.
+         */
+        PngWriter(const std::filesystem::path& filename, int width, int height, int level = defaultLevel,
+            unsigned int maxBlocksInFlight = 0);
+        ~PngWriter();
+
+        PngWriter(const PngWriter&) = delete;
+        PngWriter(PngWriter&&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+        PngWriter& operator=(PngWriter&&) = delete;
+
+        /**
+         * Append the rows of the view to the image. The rows are taken in top-down order, independent of the memory
+         * layout of the view.
+         *
+         * @param rows
+         */
+        void writeRows(const ImageView& rows);
+
+        /**
+         * Wait for all blocks to be compressed and write the end of the file. Must be called after all rows are
+         * written. Not calling finish() leaves an incomplete file.
+         */
+        void finish();
+
+    private:
+        struct Block {
+            std::vector<unsigned char> data;
+            uint32_t adler;
+            std::size_t filteredSize;
+            bool last;
+        };
+
+        void submitBlock(bool last);
+        void writeBlock(Block&& block);
+        void writeChunk(const char* type, const unsigned char* data, std::size_t size);
+
+        std::ofstream file_;
+        int width_;
+        int height_;
+        int level_;
+        std::size_t maxBlocksInFlight_;
+        std::size_t rowSize_;
+        int rowsPerBlock_;
+        int rowsWritten_;
+        bool finished_;
+
+        std::vector<unsigned char> blockRows_;
+        int blockNumRows_;
+        std::vector<unsigned char> prevRow_;
+        std::shared_future<std::vector<unsigned char>> prevTail_;
+
+        std::deque<std::future<Block>> blocksInFlight_;
+        bool headerWritten_;
+        uint32_t adler_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,133 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    // Power of two, zones of one thread which fit between two collects.
+    constexpr uint64_t ringSize = 1u << 14;
+
+    // Single producer (the owning thread), single consumer (collect) ring.
+    struct ThreadBuffer {
+        std::vector<Profiler::Zone> ring = std::vector<Profiler::Zone>(ringSize);
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> exited{false};
+        uint32_t threadIdx = 0;
+        uint32_t depth = 0; // Only accessed by the owning thread.
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        uint32_t nextThreadIdx = 0;
+        std::unordered_map<uint32_t, std::string> threadNames; // Only explicitly named threads.
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::atomic<bool> enabled{true};
+
+    // Marks the buffer as released when the thread exits, the buffer itself is owned by the registry.
+    struct ThreadBufferHandle {
+        ThreadBuffer* buffer = nullptr;
+
+        ~ThreadBufferHandle() {
+            if (buffer != nullptr) {
+                buffer->exited.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local ThreadBufferHandle threadBuffer;
+
+    ThreadBuffer& getThreadBuffer() {
+        if (threadBuffer.buffer == nullptr) {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            auto& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            buffer->threadIdx = r.nextThreadIdx++;
+            threadBuffer.buffer = buffer.get();
+            r.buffers.push_back(std::move(buffer));
+        }
+        return *threadBuffer.buffer;
+    }
+} // namespace
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+bool Profiler::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setEnabled(bool e) {
+    enabled.store(e, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    const uint32_t threadIdx = getThreadBuffer().threadIdx;
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threadNames[threadIdx] = name;
+}
+
+uint64_t Profiler::collect(std::vector<Zone>& zones) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t dropped = 0;
+    for (auto it = r.buffers.begin(); it != r.buffers.end();) {
+        auto& buffer = **it;
+        // Check for exit before reading, so no zone written before the exit is missed.
+        const bool exited = buffer.exited.load(std::memory_order_acquire);
+        const uint64_t head = buffer.head.load(std::memory_order_acquire);
+        for (uint64_t i = buffer.tail.load(std::memory_order_relaxed); i < head; i++) {
+            zones.push_back(buffer.ring[i & (ringSize - 1)]);
+        }
+        buffer.tail.store(head, std::memory_order_release);
+        dropped += buffer.dropped.exchange(0, std::memory_order_relaxed);
+        if (exited) {
+            it = r.buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
+
+std::string Profiler::threadName(uint32_t threadIdx) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const auto it = r.threadNames.find(threadIdx);
+    return it != r.threadNames.end() ? it->second : "Thread " + std::to_string(threadIdx);
+}
+
+uint32_t Profiler::beginZone() {
+    return getThreadBuffer().depth++;
+}
+
+void Profiler::endZone(const char* name, uint64_t begin, uint32_t depth) {
+    const uint64_t end = now();
+    auto& buffer = getThreadBuffer();
+    buffer.depth = depth;
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= ringSize) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.ring[head & (ringSize - 1)] = Zone{name, begin, end, buffer.threadIdx, depth};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
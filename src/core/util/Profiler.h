@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OGL4Core2::Core {
+    /**
+     * Low-overhead CPU profiler. Code is instrumented with zones (see OGL4CORE2_PROFILE_ZONE), each thread records its
+     * finished zones into its own lock-free ring buffer and the main thread collects the zones of all threads once
+     * per frame. Writing a zone never blocks, if the ring of a thread is full (i.e., nobody collects), the zone is
+     * dropped. Buffers of exited threads are released on the next collect().
+     *
+     * Timestamps are steady clock nanoseconds relative to the start of the profiler.
+     */
+    class Profiler {
+    public:
+        struct Zone {
+            const char* name; // Static string passed to the zone macro.
+            uint64_t begin;
+            uint64_t end;
+            uint32_t threadIdx; // Index in order of the first zone recorded by a thread.
+            uint32_t depth; // Nesting level within the thread.
+        };
+
+        [[nodiscard]] static uint64_t now();
+
+        [[nodiscard]] static bool isEnabled();
+        static void setEnabled(bool enabled);
+
+        /**
+         * Name of the calling thread, shown in the GUI and exported traces.
+         *
+         * @param name
+         */
+        static void setThreadName(const std::string& name);
+
+        /**
+         * Append the zones finished since the last call to zones. Must only be called from one thread at a time.
+         *
+         * @param zones
+         * @return Number of zones dropped since the last call, because a ring buffer was full.
+         */
+        static uint64_t collect(std::vector<Zone>& zones);
+
+        /**
+         * Name of a thread set with setThreadName(), also after the thread has exited, or "Thread <idx>" otherwise.
+         *
+         * @param threadIdx
+         * @return name
+         */
+        [[nodiscard]] static std::string threadName(uint32_t threadIdx);
+
+        // Used by ProfileZone.
+        static uint32_t beginZone();
+        static void endZone(const char* name, uint64_t begin, uint32_t depth);
+    };
+
+    /**
+     * Records a profiler zone from construction to destruction, use the macros below.
+     */
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) : name_(name), begin_(0), depth_(0), active_(Profiler::isEnabled()) {
+            if (active_) {
+                depth_ = Profiler::beginZone();
+                begin_ = Profiler::now();
+            }
+        }
+        ~ProfileZone() {
+            if (active_) {
+                Profiler::endZone(name_, begin_, depth_);
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone(ProfileZone&&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+        ProfileZone& operator=(ProfileZone&&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t begin_;
+        uint32_t depth_;
+        bool active_;
+    };
+} // namespace OGL4Core2::Core
+
+#define OGL4CORE2_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OGL4CORE2_PROFILE_CONCAT(a, b) OGL4CORE2_PROFILE_CONCAT_IMPL(a, b)
+
+// Zone names must be string literals (or have static storage duration), only the pointer is recorded.
+#ifdef OGL4CORE2_DISABLE_PROFILER
+#define OGL4CORE2_PROFILE_ZONE(name)
+#else
+#define OGL4CORE2_PROFILE_ZONE(name) \
+    const ::OGL4Core2::Core::ProfileZone OGL4CORE2_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#endif
+#define OGL4CORE2_PROFILE_FUNCTION() OGL4CORE2_PROFILE_ZONE(__func__)
@@ -0,0 +1,100 @@
+#include "ReadbackRing.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace OGL4Core2::Core;
+
+ReadbackRing::ReadbackRing(std::size_t size) : next_(0) {
+    if (size == 0) {
+        throw std::invalid_argument("Readback ring size must be greater than zero!");
+    }
+    slots_.resize(size);
+    for (auto& slot : slots_) {
+        glCreateBuffers(1, &slot.buffer);
+    }
+}
+
+ReadbackRing::~ReadbackRing() {
+    for (auto& slot : slots_) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+        }
+        glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+void ReadbackRing::start(uint64_t frameNumber, int width, int height, GLuint framebuffer) {
+    if (full()) {
+        throw std::runtime_error("Readback ring is full!");
+    }
+    auto& slot = slots_[next_];
+
+    const auto size = static_cast<GLsizeiptr>(width) * static_cast<GLsizeiptr>(height) * 4;
+    if (size > slot.capacity) {
+        glNamedBufferData(slot.buffer, size, nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(framebuffer == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameNumber = frameNumber;
+    slot.width = width;
+    slot.height = height;
+
+    pending_.push_back(next_);
+    next_ = (next_ + 1) % slots_.size();
+}
+
+bool ReadbackRing::pop(Frame& frame, bool wait) {
+    if (pending_.empty()) {
+        return false;
+    }
+    auto& slot = slots_[pending_.front()];
+
+    if (wait) {
+        // Flush on first wait only, to make sure the fence is actually submitted to the GPU.
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        GLenum status;
+        do {
+            status = glClientWaitSync(slot.fence, flags, 1000000000);
+            flags = 0;
+        } while (status == GL_TIMEOUT_EXPIRED);
+        if (status == GL_WAIT_FAILED) {
+            throw std::runtime_error("Waiting for readback fence failed!");
+        }
+    } else {
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        if (status == GL_WAIT_FAILED) {
+            throw std::runtime_error("Waiting for readback fence failed!");
+        }
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const auto size = static_cast<GLsizeiptr>(slot.width) * static_cast<GLsizeiptr>(slot.height) * 4;
+    frame.frameNumber = slot.frameNumber;
+    frame.width = slot.width;
+    frame.height = slot.height;
+    frame.pixels.resize(static_cast<std::size_t>(size));
+
+    const void* data = glMapNamedBufferRange(slot.buffer, 0, size, GL_MAP_READ_BIT);
+    if (data == nullptr) {
+        pending_.pop_front();
+        throw std::runtime_error("Cannot map readback buffer!");
+    }
+    std::memcpy(frame.pixels.data(), data, static_cast<std::size_t>(size));
+    glUnmapNamedBuffer(slot.buffer);
+
+    pending_.pop_front();
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "Image.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Asynchronous readback of the rendered frame using a ring of pixel pack buffers. A readback is started with
+     * start() right after drawing a frame, the GPU copies the pixels into one of the buffers while the application
+     * continues rendering, and the result is collected some frames later with pop(). A fence sync per buffer is used to
+     * check if the copy is finished without stalling the pipeline. Buffers are reused across readbacks and only
+     * reallocated if the framebuffer grows.
+     *
+     * All methods, including the destructor, require the OpenGL context to be current.
+     */
+    class ReadbackRing {
+    public:
+        struct Frame {
+            uint64_t frameNumber = 0;
+            int width = 0;
+            int height = 0;
+            std::vector<unsigned char> pixels; // RGBA, bottom-up row order as returned by glReadPixels.
+
+            [[nodiscard]] inline ImageView view() const {
+                return ImageView(pixels.data(), width, height, true);
+            }
+        };
+
+        explicit ReadbackRing(std::size_t size = 3);
+        ~ReadbackRing();
+
+        ReadbackRing(const ReadbackRing&) = delete;
+        ReadbackRing(ReadbackRing&&) = delete;
+        ReadbackRing& operator=(const ReadbackRing&) = delete;
+        ReadbackRing& operator=(ReadbackRing&&) = delete;
+
+        /**
+         * Start reading the current back buffer (or the first color attachment of an offscreen framebuffer) into the
+         * next free buffer of the ring. The ring must not be full, use pop() with wait = true to free the oldest buffer
+         * first.
+         *
+         * @param frameNumber
+         * @param width
+         * @param height
+         * @param framebuffer Framebuffer to read from, 0 reads the back buffer of the window.
+         */
+        void start(uint64_t frameNumber, int width, int height, GLuint framebuffer = 0);
+
+        /**
+         * Collect the oldest pending readback. Without waiting, this returns false if the GPU has not finished the
+         * copy yet. With waiting, this only returns false if there is no pending readback at all.
+         *
+         * @param frame Output frame, the pixel vector is resized as needed.
+         * @param wait Block until the oldest readback is finished.
+         * @return bool
+         */
+        bool pop(Frame& frame, bool wait = false);
+
+        [[nodiscard]] inline bool empty() const {
+            return pending_.empty();
+        }
+        [[nodiscard]] inline bool full() const {
+            return pending_.size() >= slots_.size();
+        }
+
+    private:
+        struct Slot {
+            GLuint buffer = 0;
+            GLsizeiptr capacity = 0;
+            GLsync fence = nullptr;
+            uint64_t frameNumber = 0;
+            int width = 0;
+            int height = 0;
+        };
+
+        std::vector<Slot> slots_;
+        std::deque<std::size_t> pending_;
+        std::size_t next_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,52 @@
+#include "SharedLibrary.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX 1
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+using namespace OGL4Core2::Core;
+
+SharedLibrary::SharedLibrary(const std::filesystem::path& filename) : handle_(nullptr) {
+#ifdef _WIN32
+    handle_ = static_cast<void*>(LoadLibraryW(filename.wstring().c_str()));
+    if (handle_ == nullptr) {
+        throw std::runtime_error("Cannot load library \"" + filename.string() + "\" (error " +
+                                 std::to_string(GetLastError()) + ")!");
+    }
+#else
+    // Local binding, so equally named symbols of different libraries or different versions of the same library do
+    // not interfere.
+    handle_ = dlopen(filename.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle_ == nullptr) {
+        const char* error = dlerror();
+        throw std::runtime_error("Cannot load library \"" + filename.string() + "\": " +
+                                 (error != nullptr ? error : "unknown error") + "!");
+    }
+#endif
+}
+
+SharedLibrary::~SharedLibrary() {
+#ifdef _WIN32
+    FreeLibrary(static_cast<HMODULE>(handle_));
+#else
+    dlclose(handle_);
+#endif
+}
+
+void* SharedLibrary::symbol(const std::string& name) const {
+#ifdef _WIN32
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle_), name.c_str()));
+#else
+    return dlsym(handle_, name.c_str());
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace OGL4Core2::Core {
+    /**
+     * Shared library loaded at runtime with dlopen() or LoadLibrary(). The library is unloaded on destruction, so no
+     * object, function pointer or string owned by the library must be used afterwards.
+     */
+    class SharedLibrary {
+    public:
+        explicit SharedLibrary(const std::filesystem::path& filename);
+        ~SharedLibrary();
+
+        SharedLibrary(const SharedLibrary&) = delete;
+        SharedLibrary(SharedLibrary&&) = delete;
+        SharedLibrary& operator=(const SharedLibrary&) = delete;
+        SharedLibrary& operator=(SharedLibrary&&) = delete;
+
+        /**
+         * @param name
+         * @return Address of the exported symbol, nullptr if it does not exist.
+         */
+        [[nodiscard]] void* symbol(const std::string& name) const;
+
+        template<typename F>
+        [[nodiscard]] F function(const std::string& name) const {
+            return reinterpret_cast<F>(symbol(name));
+        }
+
+    private:
+        void* handle_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,377 @@
+#include "TextureCooker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "ImageUtil.h"
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    // Cooked texture file, modeled after KTX2 but without its data format descriptor, as all textures are RGBA8:
+    // magic and version, uint64 hash of the source file, int32 width, height and number of levels, followed by the
+    // levels from the largest to the smallest in MipChain layout. All values are stored in native byte order.
+    constexpr std::array<char, 8> cookedMagic{'O', 'G', 'L', '4', 'T', 'E', 'X', 'C'};
+    constexpr uint32_t cookedVersion = 2; // Version 2 filters odd sizes with three taps.
+    constexpr char cookedExtension[] = ".tex";
+    // Reference from a version of a source file to the cooked file of its content, so an unchanged source is not read:
+    // magic and version, uint64 hash of the source content, int64 modification time, uint64 size and the canonical
+    // path of the source as uint32 length followed by the characters.
+    constexpr std::array<char, 8> refMagic{'O', 'G', 'L', '4', 'T', 'R', 'E', 'F'};
+    constexpr uint32_t refVersion = 1;
+    constexpr char refExtension[] = ".ref";
+    // Larger than GL_MAX_TEXTURE_SIZE of all current GPUs, limits the allocation for a corrupted header.
+    constexpr int32_t maxCookedSize = 32768;
+
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool readValue(std::istream& is, T& value) {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    // Source texels and weights of texel x of a level with the given size, when halving the size of the source level.
+    // Even sizes average two texels. Odd sizes 2n+1 use three texels with weights (n-x, n, x+1)/(2n+1), so every
+    // source texel, including the last one, contributes with its full area.
+    struct Taps {
+        std::array<int, 3> index{};
+        std::array<float, 3> weight{};
+        int count = 0;
+    };
+
+    Taps halvingTaps(int x, int size, int srcSize) {
+        Taps taps;
+        if (srcSize == 1) {
+            taps.index = {0, 0, 0};
+            taps.weight = {1.0f, 0.0f, 0.0f};
+            taps.count = 1;
+        } else if (srcSize % 2 == 0) {
+            taps.index = {2 * x, 2 * x + 1, 0};
+            taps.weight = {0.5f, 0.5f, 0.0f};
+            taps.count = 2;
+        } else {
+            const auto n = static_cast<float>(srcSize);
+            taps.index = {2 * x, 2 * x + 1, 2 * x + 2};
+            taps.weight = {
+                static_cast<float>(size - x) / n, static_cast<float>(size) / n, static_cast<float>(x + 1) / n};
+            taps.count = 3;
+        }
+        return taps;
+    }
+
+    std::vector<unsigned char> readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot read resource file \"" + path.string() + "\"!");
+        }
+        return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // FNV-1a, fast enough to be negligible compared to decoding the file.
+    uint64_t hashBytes(const void* data, std::size_t size, uint64_t hash = 14695981039346656037ull) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string hashName(uint64_t hash, const char* extension) {
+        std::array<char, 17> name{};
+        std::snprintf(name.data(), name.size(), "%016llx", static_cast<unsigned long long>(hash));
+        return std::string(name.data()) + extension;
+    }
+
+    // Same key as used by the ResourceCache to detect changed files.
+    struct SourceState {
+        std::string path;
+        int64_t writeTime = 0;
+        uint64_t size = 0;
+
+        bool operator==(const SourceState& other) const {
+            return path == other.path && writeTime == other.writeTime && size == other.size;
+        }
+
+        [[nodiscard]] uint64_t hash() const {
+            uint64_t hash = hashBytes(path.data(), path.size());
+            hash = hashBytes(&writeTime, sizeof(writeTime), hash);
+            return hashBytes(&size, sizeof(size), hash);
+        }
+    };
+
+    SourceState sourceState(const std::filesystem::path& path) {
+        std::error_code ec;
+        std::filesystem::path resolved = std::filesystem::canonical(path, ec);
+        if (ec) {
+            resolved = path;
+        }
+        SourceState state;
+        state.path = resolved.string();
+        state.writeTime = static_cast<int64_t>(std::filesystem::last_write_time(resolved).time_since_epoch().count());
+        state.size = static_cast<uint64_t>(std::filesystem::file_size(resolved));
+        return state;
+    }
+
+    // Write to a temporary file and rename it, so readers never see a partially written file.
+    void writeFile(const std::filesystem::path& filename, const std::function<void(std::ostream& os)>& write) {
+        const std::filesystem::path tmpFilename = filename.string() + "." + std::to_string(std::random_device{}());
+        {
+            std::ofstream file(tmpFilename, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot open file: \"" + tmpFilename.string() + "\"!");
+            }
+            write(file);
+            if (!file) {
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(tmpFilename, ec);
+                throw std::runtime_error("Cannot write file: \"" + tmpFilename.string() + "\"!");
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpFilename, filename, ec);
+        if (ec) {
+            std::filesystem::remove(tmpFilename, ec);
+            throw std::runtime_error("Cannot rename file: \"" + tmpFilename.string() + "\"!");
+        }
+    }
+
+    bool readRef(const std::filesystem::path& filename, const SourceState& state, uint64_t& sourceHash) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::array<char, 8> magic{};
+        uint32_t version = 0;
+        SourceState refState;
+        uint32_t pathLength = 0;
+        if (!file.read(magic.data(), magic.size()) || magic != refMagic || !readValue(file, version) ||
+            version != refVersion || !readValue(file, sourceHash) || !readValue(file, refState.writeTime) ||
+            !readValue(file, refState.size) || !readValue(file, pathLength) || pathLength != state.path.size()) {
+            return false;
+        }
+        refState.path.resize(pathLength);
+        return file.read(refState.path.data(), pathLength) && refState == state;
+    }
+
+    void writeRef(const std::filesystem::path& filename, const SourceState& state, uint64_t sourceHash) {
+        writeFile(filename, [&](std::ostream& os) {
+            os.write(refMagic.data(), refMagic.size());
+            writeValue(os, refVersion);
+            writeValue(os, sourceHash);
+            writeValue(os, state.writeTime);
+            writeValue(os, state.size);
+            writeValue(os, static_cast<uint32_t>(state.path.size()));
+            os.write(state.path.data(), static_cast<std::streamsize>(state.path.size()));
+        });
+    }
+
+    bool readCooked(const std::filesystem::path& filename, uint64_t sourceHash, MipChain& chain) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::array<char, 8> magic{};
+        uint32_t version = 0;
+        uint64_t hash = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t numLevels = 0;
+        if (!file.read(magic.data(), magic.size()) || magic != cookedMagic || !readValue(file, version) ||
+            version != cookedVersion || !readValue(file, hash) || hash != sourceHash || !readValue(file, width) ||
+            !readValue(file, height) || !readValue(file, numLevels) || width <= 0 || height <= 0 ||
+            width > maxCookedSize || height > maxCookedSize || numLevels != MipChain::numLevelsFor(width, height)) {
+            return false;
+        }
+        // Nothing is allocated for a file which does not contain all levels.
+        std::size_t levelsSize = 0;
+        for (int level = 0; level < numLevels; level++) {
+            levelsSize += static_cast<std::size_t>(MipChain::levelSize(width, level)) *
+                          static_cast<std::size_t>(MipChain::levelSize(height, level)) * ImageView::pixelSize;
+        }
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(filename, ec);
+        if (ec || fileSize != static_cast<std::uintmax_t>(file.tellg()) + levelsSize) {
+            return false;
+        }
+        chain.width = width;
+        chain.height = height;
+        chain.levels.resize(numLevels);
+        for (int level = 0; level < numLevels; level++) {
+            auto& pixels = chain.levels[level];
+            pixels.resize(static_cast<std::size_t>(MipChain::levelSize(width, level)) *
+                          static_cast<std::size_t>(MipChain::levelSize(height, level)) * ImageView::pixelSize);
+            if (!file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()))) {
+                return false;
+            }
+        }
+        return file.peek() == std::ifstream::traits_type::eof();
+    }
+
+    void writeCooked(const std::filesystem::path& filename, uint64_t sourceHash, const MipChain& chain) {
+        writeFile(filename, [&](std::ostream& os) {
+            os.write(cookedMagic.data(), cookedMagic.size());
+            writeValue(os, cookedVersion);
+            writeValue(os, sourceHash);
+            writeValue(os, static_cast<int32_t>(chain.width));
+            writeValue(os, static_cast<int32_t>(chain.height));
+            writeValue(os, static_cast<int32_t>(chain.numLevels()));
+            for (const auto& pixels : chain.levels) {
+                os.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+            }
+        });
+    }
+} // namespace
+
+int MipChain::numLevelsFor(int width, int height) {
+    int numLevels = 1;
+    while ((std::max(width, height) >> numLevels) > 0) {
+        numLevels++;
+    }
+    return numLevels;
+}
+
+std::size_t MipChain::memoryUsage() const {
+    std::size_t size = 0;
+    for (const auto& pixels : levels) {
+        size += pixels.size();
+    }
+    return size;
+}
+
+TextureCooker::TextureCooker(std::filesystem::path directory)
+    : directory_(std::move(directory)),
+      hits_(0),
+      misses_(0) {
+    if (directory_.empty()) {
+        return;
+    }
+    // The cache is an optimization only, without a directory textures are cooked on every load.
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "Cannot create texture cache directory \"" << directory_.string() << "\": " << ec.message()
+                  << std::endl;
+        directory_.clear();
+    }
+}
+
+MipChain TextureCooker::load(const std::filesystem::path& path) const {
+    if (directory_.empty()) {
+        misses_++;
+        return generateMipChain(ImageUtil::decodePngImage(readFile(path)).view());
+    }
+
+    // Fast path, an unchanged source file is not read at all.
+    const SourceState state = sourceState(path);
+    const std::filesystem::path refFilename = directory_ / hashName(state.hash(), refExtension);
+    uint64_t hash = 0;
+    MipChain chain;
+    if (readRef(refFilename, state, hash) && readCooked(directory_ / hashName(hash, cookedExtension), hash, chain)) {
+        hits_++;
+        return chain;
+    }
+
+    // The content may have been cooked before, e.g., for a copy of the file or if only the modification time changed.
+    const std::vector<unsigned char> png = readFile(path);
+    hash = hashBytes(png.data(), png.size());
+    const std::filesystem::path filename = directory_ / hashName(hash, cookedExtension);
+    const bool cooked = readCooked(filename, hash, chain);
+    if (cooked) {
+        hits_++;
+    } else {
+        misses_++;
+        chain = generateMipChain(ImageUtil::decodePngImage(png).view());
+    }
+    try {
+        if (!cooked) {
+            writeCooked(filename, hash, chain);
+        }
+        writeRef(refFilename, state, hash);
+    } catch (const std::exception& ex) {
+        std::cerr << "Cannot cache texture \"" << path.string() << "\": " << ex.what() << std::endl;
+    }
+    return chain;
+}
+
+MipChain TextureCooker::generateMipChain(const ImageView& image) {
+    MipChain chain;
+    chain.width = image.width;
+    chain.height = image.height;
+    chain.levels.resize(MipChain::numLevelsFor(image.width, image.height));
+
+    auto& base = chain.levels[0];
+    base.resize(image.rowSize() * static_cast<std::size_t>(image.height));
+    for (int y = 0; y < image.height; y++) {
+        std::copy_n(image.rowFromBottom(y), image.rowSize(),
+            base.data() + static_cast<std::size_t>(y) * image.rowSize());
+    }
+
+    constexpr int p = static_cast<int>(ImageView::pixelSize);
+    for (int level = 1; level < chain.numLevels(); level++) {
+        const ImageView src = chain.level(level - 1);
+        const int width = MipChain::levelSize(chain.width, level);
+        const int height = MipChain::levelSize(chain.height, level);
+        auto& dst = chain.levels[level];
+        dst.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * ImageView::pixelSize);
+        for (int y = 0; y < height; y++) {
+            const Taps tapsY = halvingTaps(y, height, src.height);
+            unsigned char* out = dst.data() + static_cast<std::size_t>(y) * width * p;
+            for (int x = 0; x < width; x++) {
+                const Taps tapsX = halvingTaps(x, width, src.width);
+                std::array<float, ImageView::pixelSize> sum{};
+                for (int j = 0; j < tapsY.count; j++) {
+                    const unsigned char* row = src.rowFromBottom(tapsY.index[j]);
+                    for (int i = 0; i < tapsX.count; i++) {
+                        const float weight = tapsY.weight[j] * tapsX.weight[i];
+                        for (int c = 0; c < p; c++) {
+                            sum[c] += weight * static_cast<float>(row[tapsX.index[i] * p + c]);
+                        }
+                    }
+                }
+                for (int c = 0; c < p; c++) {
+                    out[x * p + c] = static_cast<unsigned char>(std::min(255.0f, sum[c] + 0.5f));
+                }
+            }
+        }
+    }
+    return chain;
+}
+
+std::filesystem::path TextureCooker::defaultDirectory() {
+    // A per-user directory, cooked files are loaded without checking their content against the source.
+#ifdef _WIN32
+    const char* localAppData = std::getenv("LOCALAPPDATA");
+    if (localAppData != nullptr && std::filesystem::path(localAppData).is_absolute()) {
+        return std::filesystem::path(localAppData) / "OGL4Core2" / "texture-cache";
+    }
+#else
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome != nullptr && std::filesystem::path(cacheHome).is_absolute()) {
+        return std::filesystem::path(cacheHome) / "OGL4Core2" / "texture-cache";
+    }
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && std::filesystem::path(home).is_absolute()) {
+        return std::filesystem::path(home) / ".cache" / "OGL4Core2" / "texture-cache";
+    }
+#endif
+    return {};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Image.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * RGBA image with a full mipmap chain down to 1x1. Each level is tightly packed with the rows in OpenGL order
+     * (bottom-up), so every level is uploaded with a single call.
+     */
+    struct MipChain {
+        std::vector<std::vector<unsigned char>> levels; // Largest level first.
+        int width = 0;
+        int height = 0;
+
+        [[nodiscard]] static inline int levelSize(int size, int level) {
+            return std::max(1, size >> level);
+        }
+
+        [[nodiscard]] static int numLevelsFor(int width, int height);
+
+        [[nodiscard]] inline int numLevels() const {
+            return static_cast<int>(levels.size());
+        }
+
+        [[nodiscard]] inline ImageView level(int level) const {
+            return ImageView(levels[level].data(), levelSize(width, level), levelSize(height, level), true);
+        }
+
+        [[nodiscard]] std::size_t memoryUsage() const;
+    };
+
+    /**
+     * Turns PNG files into textures with a full mipmap chain generated on the CPU and keeps the result in a cache
+     * directory, so later loads only read the cooked file instead of decoding the PNG and filtering the mipmaps.
+     * Cooked files are named by a hash of the PNG content, so an edited source never hits a stale entry and
+     * identical files share one entry. A small reference file per source path, modification time and size points to
+     * the cooked file, so unchanged sources are neither read nor hashed. The directory is never cleaned up
+     * automatically, it can be deleted at any time.
+     *
+     * Thread-safe. Cooked files are written under a temporary name and renamed afterwards, so concurrent loads, also
+     * by other processes, never read a partially written file.
+     */
+    class TextureCooker {
+    public:
+        /**
+         * @param directory Cache directory, created if missing. Empty disables the cache, PNG files are then cooked on
+         *                  every load.
+         */
+        explicit TextureCooker(std::filesystem::path directory);
+        ~TextureCooker() = default;
+
+        TextureCooker(const TextureCooker&) = delete;
+        TextureCooker(TextureCooker&&) = delete;
+        TextureCooker& operator=(const TextureCooker&) = delete;
+        TextureCooker& operator=(TextureCooker&&) = delete;
+
+        /**
+         * Cooked texture of the PNG file, read from the cache directory or cooked and written to it. Failing to write
+         * the cooked file is reported to std::cerr, the texture is returned anyway.
+         *
+         * @param path Existing PNG file.
+         */
+        [[nodiscard]] MipChain load(const std::filesystem::path& path) const;
+
+        /**
+         * Generate the mipmap chain with a box filter over the area of each texel: even sizes average two texels per
+         * axis, odd sizes three weighted texels, so the last row or column is not dropped.
+         *
+         * @param image Level 0, in any row order.
+         */
+        [[nodiscard]] static MipChain generateMipChain(const ImageView& image);
+
+        // Per-user cache directory, i.e., $XDG_CACHE_HOME or ~/.cache, %LOCALAPPDATA% on Windows, empty if unknown.
+        [[nodiscard]] static std::filesystem::path defaultDirectory();
+
+        [[nodiscard]] inline const std::filesystem::path& directory() const {
+            return directory_;
+        }
+        [[nodiscard]] inline std::size_t hits() const {
+            return hits_;
+        }
+        [[nodiscard]] inline std::size_t misses() const {
+            return misses_;
+        }
+
+    private:
+        std::filesystem::path directory_;
+        mutable std::atomic<std::size_t> hits_;
+        mutable std::atomic<std::size_t> misses_;
+    };
+} // namespace OGL4Core2::Core
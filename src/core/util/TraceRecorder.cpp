@@ -0,0 +1,303 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include "JsonUtil.h"
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    // Binary stream: magic and version, followed by records starting with a type byte. Names and tracks are defined
+    // before the first event using them. All values are stored in native byte order.
+    constexpr std::array<char, 8> binaryMagic{'O', 'G', 'L', '4', 'T', 'R', 'C', 'E'};
+    constexpr uint32_t binaryVersion = 1;
+    enum class RecordType : uint8_t {
+        Name = 1,  // uint32 id, uint32 length, chars
+        Track = 2, // uint32 track, uint32 length, chars
+        Event = 3, // uint32 track, uint32 name id, uint64 begin, uint64 end
+        Frame = 4, // uint64 frame number, uint64 begin, uint64 end
+    };
+
+    constexpr uint32_t gpuTrack = std::numeric_limits<uint32_t>::max();
+
+    template<typename T>
+    void writeValue(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool readValue(std::istream& is, T& value) {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    void writeString(std::ostream& os, RecordType type, uint32_t id, const std::string& str) {
+        writeValue(os, type);
+        writeValue(os, id);
+        writeValue(os, static_cast<uint32_t>(str.size()));
+        os.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+
+    // Writes trace events one by one, timestamps are converted from nanoseconds to microseconds.
+    class JsonTraceWriter {
+    public:
+        explicit JsonTraceWriter(std::ostream& os) : os_(os), first_(true) {
+            os_ << std::fixed << std::setprecision(3);
+            os_ << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        }
+
+        void track(uint32_t track, const std::string& name) {
+            next();
+            os_ << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << track
+                << ", \"args\": {\"name\": \"" << JsonUtil::escape(name) << "\"}}";
+            // Sort GPU below all CPU threads.
+            next();
+            os_ << "{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << track
+                << ", \"args\": {\"sort_index\": " << track << "}}";
+        }
+
+        void event(uint32_t track, const std::string& name, uint64_t begin, uint64_t end) {
+            next();
+            os_ << "{\"name\": \"" << JsonUtil::escape(name) << "\", \"cat\": \"" << (track == gpuTrack ? "gpu" : "cpu")
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << track << ", \"ts\": " << toUs(begin)
+                << ", \"dur\": " << toUs(end - begin) << "}";
+        }
+
+        void frame(uint64_t frameNumber, uint64_t begin, uint64_t end) {
+            next();
+            os_ << "{\"name\": \"Frame " << frameNumber << "\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 1, \"tid\": 0"
+                << ", \"ts\": " << toUs(begin) << ", \"args\": {\"frame\": " << frameNumber
+                << ", \"duration_ms\": " << static_cast<double>(end - begin) * 1.0e-6 << "}}";
+        }
+
+        void finish() {
+            os_ << "\n]}\n";
+        }
+
+    private:
+        void next() {
+            os_ << (first_ ? "\n" : ",\n");
+            first_ = false;
+        }
+
+        static double toUs(uint64_t ns) {
+            return static_cast<double>(ns) * 1.0e-3;
+        }
+
+        std::ostream& os_;
+        bool first_;
+    };
+} // namespace
+
+TraceRecorder::TraceRecorder(std::size_t maxFrames, const std::filesystem::path& streamFilename)
+    : maxFrames_(maxFrames),
+      stream_(nullptr) {
+    if (maxFrames_ == 0) {
+        throw std::invalid_argument("Number of trace frames must be greater than zero!");
+    }
+    if (!streamFilename.empty()) {
+        stream_ = std::make_unique<std::ofstream>(streamFilename, std::ios::binary);
+        if (!stream_->is_open()) {
+            throw std::runtime_error("Cannot open file: \"" + streamFilename.string() + "\"!");
+        }
+        stream_->write(binaryMagic.data(), binaryMagic.size());
+        writeValue(*stream_, binaryVersion);
+    }
+    addTrack(gpuTrack, "GPU");
+}
+
+void TraceRecorder::addFrame(uint64_t frameNumber, uint64_t begin, uint64_t end) {
+    frames_.push_back({frameNumber, begin, end});
+    if (stream_ != nullptr) {
+        writeValue(*stream_, RecordType::Frame);
+        writeValue(*stream_, frameNumber);
+        writeValue(*stream_, begin);
+        writeValue(*stream_, end);
+    }
+    // Drop the oldest frame and all events which ended before the new oldest frame. Events are roughly ordered by
+    // time, late events (i.e., from the GPU) are dropped once they reach the front.
+    if (frames_.size() > maxFrames_) {
+        frames_.pop_front();
+        const uint64_t oldest = frames_.front().begin;
+        while (!events_.empty() && events_.front().end < oldest) {
+            events_.pop_front();
+        }
+    }
+}
+
+void TraceRecorder::addCpuZones(const std::vector<Profiler::Zone>& zones) {
+    for (const auto& zone : zones) {
+        if (tracks_.find(zone.threadIdx) == tracks_.end()) {
+            addTrack(zone.threadIdx, Profiler::threadName(zone.threadIdx));
+        }
+        addEvent({zone.threadIdx, cpuNameId(zone.name), zone.begin, zone.end});
+    }
+}
+
+void TraceRecorder::addGpuFrame(const GpuTimer::Frame& frame, int64_t gpuToCpuOffset) {
+    const auto toCpu = [gpuToCpuOffset](uint64_t t) {
+        return static_cast<uint64_t>(std::max<int64_t>(static_cast<int64_t>(t) + gpuToCpuOffset, 0));
+    };
+    addEvent({gpuTrack, nameId("Frame"), toCpu(frame.begin), toCpu(frame.end)});
+    for (const auto& scope : frame.scopes) {
+        addEvent({gpuTrack, nameId(scope.name), toCpu(scope.begin), toCpu(scope.end)});
+    }
+}
+
+void TraceRecorder::saveJson(const std::filesystem::path& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + filename.string() + "\"!");
+    }
+    JsonTraceWriter writer(file);
+    for (const auto& [track, name] : tracks_) {
+        writer.track(track, name);
+    }
+    for (const auto& frame : frames_) {
+        writer.frame(frame.frameNumber, frame.begin, frame.end);
+    }
+    for (const auto& event : events_) {
+        writer.event(event.track, names_[event.nameId], event.begin, event.end);
+    }
+    writer.finish();
+    if (!file.good()) {
+        throw std::runtime_error("Error writing file: \"" + filename.string() + "\"!");
+    }
+}
+
+void TraceRecorder::convertBinaryToJson(const std::filesystem::path& binaryFilename,
+    const std::filesystem::path& jsonFilename) {
+    std::ifstream in(binaryFilename, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + binaryFilename.string() + "\"!");
+    }
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    in.read(magic.data(), magic.size());
+    if (!in || magic != binaryMagic || !readValue(in, version) || version != binaryVersion) {
+        throw std::runtime_error("Invalid trace file: \"" + binaryFilename.string() + "\"!");
+    }
+    std::ofstream out(jsonFilename);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open file: \"" + jsonFilename.string() + "\"!");
+    }
+
+    // Events are converted while reading, only the names are held in memory.
+    JsonTraceWriter writer(out);
+    std::vector<std::string> names;
+    const auto readString = [&in](uint32_t& id, std::string& str) {
+        uint32_t length = 0;
+        if (!readValue(in, id) || !readValue(in, length)) {
+            return false;
+        }
+        str.resize(length);
+        return static_cast<bool>(in.read(str.data(), length));
+    };
+    RecordType type{};
+    bool truncated = false;
+    while (!truncated && readValue(in, type)) {
+        switch (type) {
+            case RecordType::Name: {
+                uint32_t id = 0;
+                std::string name;
+                truncated = !readString(id, name);
+                if (!truncated) {
+                    // Name ids are handed out sequentially, a larger id is corrupt data.
+                    if (id > names.size()) {
+                        throw std::runtime_error("Invalid trace file: \"" + binaryFilename.string() + "\"!");
+                    }
+                    if (id == names.size()) {
+                        names.push_back(std::move(name));
+                    } else {
+                        names[id] = std::move(name);
+                    }
+                }
+                break;
+            }
+            case RecordType::Track: {
+                uint32_t track = 0;
+                std::string name;
+                truncated = !readString(track, name);
+                if (!truncated) {
+                    writer.track(track, name);
+                }
+                break;
+            }
+            case RecordType::Event: {
+                uint32_t track = 0;
+                uint32_t nameId = 0;
+                uint64_t begin = 0;
+                uint64_t end = 0;
+                truncated = !readValue(in, track) || !readValue(in, nameId) || !readValue(in, begin) ||
+                            !readValue(in, end);
+                if (!truncated) {
+                    if (nameId >= names.size()) {
+                        throw std::runtime_error("Invalid trace file: \"" + binaryFilename.string() + "\"!");
+                    }
+                    writer.event(track, names[nameId], begin, end);
+                }
+                break;
+            }
+            case RecordType::Frame: {
+                uint64_t frameNumber = 0;
+                uint64_t begin = 0;
+                uint64_t end = 0;
+                truncated = !readValue(in, frameNumber) || !readValue(in, begin) || !readValue(in, end);
+                if (!truncated) {
+                    writer.frame(frameNumber, begin, end);
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Invalid trace file: \"" + binaryFilename.string() + "\"!");
+        }
+    }
+    // A truncated last record (e.g., the application crashed) is ignored, everything before is still valid.
+    writer.finish();
+    if (!out.good()) {
+        throw std::runtime_error("Error writing file: \"" + jsonFilename.string() + "\"!");
+    }
+}
+
+uint32_t TraceRecorder::cpuNameId(const char* name) {
+    auto it = cpuNameIds_.find(name);
+    if (it == cpuNameIds_.end()) {
+        it = cpuNameIds_.emplace(name, nameId(name)).first;
+    }
+    return it->second;
+}
+
+uint32_t TraceRecorder::nameId(const std::string& name) {
+    auto it = nameIds_.find(name);
+    if (it == nameIds_.end()) {
+        const auto id = static_cast<uint32_t>(names_.size());
+        it = nameIds_.emplace(name, id).first;
+        names_.push_back(name);
+        if (stream_ != nullptr) {
+            writeString(*stream_, RecordType::Name, id, name);
+        }
+    }
+    return it->second;
+}
+
+void TraceRecorder::addTrack(uint32_t track, const std::string& name) {
+    tracks_[track] = name;
+    if (stream_ != nullptr) {
+        writeString(*stream_, RecordType::Track, track, name);
+    }
+}
+
+void TraceRecorder::addEvent(const Event& event) {
+    events_.push_back(event);
+    if (stream_ != nullptr) {
+        writeValue(*stream_, RecordType::Event);
+        writeValue(*stream_, event.track);
+        writeValue(*stream_, event.nameId);
+        writeValue(*stream_, event.begin);
+        writeValue(*stream_, event.end);
+    }
+}
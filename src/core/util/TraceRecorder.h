@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GpuTimer.h"
+#include "Profiler.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Records CPU profiler zones, GPU timer results and frame boundaries for offline analysis. The events of the last
+     * frames are kept in memory and can be saved as Chrome trace-event JSON at any time, which can be opened in
+     * chrome://tracing or https://ui.perfetto.dev. For long runs, all events can additionally be streamed into a
+     * compact binary file, which is converted to JSON afterwards with convertBinaryToJson().
+     *
+     * GPU timestamps are mapped to the profiler clock with an offset measured by the caller.
+     */
+    class TraceRecorder {
+    public:
+        /**
+         * @param maxFrames Number of frames kept in memory.
+         * @param streamFilename Binary output, if not empty all events are streamed into this file.
+         */
+        explicit TraceRecorder(std::size_t maxFrames, const std::filesystem::path& streamFilename = {});
+        ~TraceRecorder() = default;
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder(TraceRecorder&&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(TraceRecorder&&) = delete;
+
+        void addFrame(uint64_t frameNumber, uint64_t begin, uint64_t end);
+        void addCpuZones(const std::vector<Profiler::Zone>& zones);
+
+        /**
+         * @param frame
+         * @param gpuToCpuOffset Profiler time minus GPU time in nanoseconds.
+         */
+        void addGpuFrame(const GpuTimer::Frame& frame, int64_t gpuToCpuOffset);
+
+        /**
+         * Forget the zone names cached by pointer. Must be called when zone names are unloaded, e.g., with a plugin
+         * module, as the addresses may be reused for other names.
+         */
+        inline void clearZoneNameCache() {
+            cpuNameIds_.clear();
+        }
+
+        /**
+         * Save the events of the frames kept in memory.
+         *
+         * @param filename
+         */
+        void saveJson(const std::filesystem::path& filename) const;
+
+        [[nodiscard]] inline std::size_t numFrames() const {
+            return frames_.size();
+        }
+
+        static void convertBinaryToJson(const std::filesystem::path& binaryFilename,
+            const std::filesystem::path& jsonFilename);
+
+    private:
+        struct Event {
+            uint32_t track;
+            uint32_t nameId;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct FrameMark {
+            uint64_t frameNumber;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        uint32_t cpuNameId(const char* name);
+        uint32_t nameId(const std::string& name);
+        void addTrack(uint32_t track, const std::string& name);
+        void addEvent(const Event& event);
+
+        std::size_t maxFrames_;
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, uint32_t> nameIds_;
+        std::unordered_map<const char*, uint32_t> cpuNameIds_; // Zone names are static, so lookup by pointer.
+        std::map<uint32_t, std::string> tracks_;
+        std::deque<Event> events_;
+        std::deque<FrameMark> frames_;
+        std::unique_ptr<std::ofstream> stream_;
+    };
+} // namespace OGL4Core2::Core
@@ -0,0 +1,49 @@
+#include "UploadBuffer.h"
+
+#include <algorithm>
+
+#include "GLUtil.h"
+
+using namespace OGL4Core2::Core;
+
+UploadBuffer::UploadBuffer() : buffer_(0), size_(0) {
+    glCreateBuffers(1, &buffer_);
+}
+
+UploadBuffer::~UploadBuffer() {
+    glDeleteBuffers(1, &buffer_);
+}
+
+void UploadBuffer::uploadImage(GLuint texture, const ImageView& image, GLint level, GLint layer) {
+    if (image.bottomUp || image.width <= 0 || image.height <= 0) {
+        GLUtil::uploadImage(texture, image, level, layer);
+        return;
+    }
+
+    const std::size_t rowSize = image.rowSize();
+    const std::size_t size = rowSize * static_cast<std::size_t>(image.height);
+    if (size > size_) {
+        // Mutable storage, so the buffer can grow. Later uploads invalidate the content, the driver then hands out
+        // new memory instead of waiting for the previous upload.
+        glNamedBufferData(buffer_, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+        size_ = size;
+    }
+    auto* staging = static_cast<unsigned char*>(glMapNamedBufferRange(buffer_, 0, static_cast<GLsizeiptr>(size),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (staging == nullptr) {
+        GLUtil::uploadImage(texture, image, level, layer);
+        return;
+    }
+    for (int y = 0; y < image.height; y++) {
+        std::copy_n(image.rowFromBottom(y), rowSize, staging + static_cast<std::size_t>(y) * rowSize);
+    }
+    // The content is undefined if the buffer was corrupted while mapped.
+    if (glUnmapNamedBuffer(buffer_) != GL_TRUE) {
+        GLUtil::uploadImage(texture, image, level, layer);
+        return;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
+    // With a bound unpack buffer the data pointer is the offset into the buffer.
+    GLUtil::uploadImage(texture, ImageView(nullptr, image.width, image.height, true), level, layer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glad/gl.h>
+
+#include "Image.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Grow-only pixel unpack buffer, reused to upload many top-down images with a single call each, e.g., all layers of
+     * a texture array. The rows are reversed while they are copied into the buffer. This copy replaces the copy the
+     * driver makes of client memory anyway, so no extra copy or flip pass is made. Requires a current OpenGL context
+     * for all methods including destructor.
+     */
+    class UploadBuffer {
+    public:
+        UploadBuffer();
+        ~UploadBuffer();
+
+        UploadBuffer(const UploadBuffer&) = delete;
+        UploadBuffer(UploadBuffer&&) = delete;
+        UploadBuffer& operator=(const UploadBuffer&) = delete;
+        UploadBuffer& operator=(UploadBuffer&&) = delete;
+
+        /**
+         * See GLUtil::uploadImage(), but top-down views are staged in the buffer instead of uploaded row by row.
+         * Bottom-up views are uploaded directly.
+         */
+        void uploadImage(GLuint texture, const ImageView& image, GLint level = 0, GLint layer = -1);
+
+    private:
+        GLuint buffer_;
+        std::size_t size_;
+    };
+} // namespace OGL4Core2::Core
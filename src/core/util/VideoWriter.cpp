@@ -0,0 +1,177 @@
+#include "VideoWriter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX 1
+#endif
+#include <io.h>
+#include <windows.h>
+#define popen _popen
+#define pclose _pclose
+#elif defined(__linux__)
+#include <fcntl.h>
+#endif
+
+using namespace OGL4Core2::Core;
+
+namespace {
+    constexpr std::size_t fileBufferSize = 4 * 1024 * 1024;
+    constexpr char y4mFrameHeader[] = "FRAME\n";
+
+    unsigned char clampToByte(int v) {
+        return static_cast<unsigned char>(std::clamp(v, 0, 255));
+    }
+
+    /**
+     * Allocate disk blocks for the file up to the given size. Unlike growing the file, which only creates a sparse
+     * file, this reserves the space, so writing the frames later neither allocates blocks nor fails for a full disk.
+     * File systems not supporting it are not emulated by writing zeros, which would take as long as the recording.
+     *
+     * @return False if the space was not allocated, the file is then written without preallocation.
+     */
+    bool preallocate([[maybe_unused]] std::FILE* file, [[maybe_unused]] uint64_t size) {
+#ifdef _WIN32
+        // Reserves clusters without moving the end of the file, they are released on close if not written.
+        FILE_ALLOCATION_INFO info;
+        info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+        const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+        return handle != INVALID_HANDLE_VALUE &&
+               SetFileInformationByHandle(handle, FileAllocationInfo, &info, sizeof(info)) != 0;
+#elif defined(__linux__)
+        // Extends the file size, the unused part is truncated when the writer is destroyed.
+        return fallocate(fileno(file), 0, 0, static_cast<off_t>(size)) == 0;
+#else
+        return false;
+#endif
+    }
+} // namespace
+
+VideoWriter::VideoWriter(const std::string& filename, Format format, int width, int height, uint64_t numFrames,
+    int fps)
+    : file_(nullptr),
+      isPipe_(false),
+      format_(format),
+      width_(width),
+      height_(height),
+      framesWritten_(0),
+      bytesWritten_(0),
+      bytesPreallocated_(0) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Invalid video frame size!");
+    }
+
+    if (!filename.empty() && filename.front() == '|') {
+        isPipe_ = true;
+        file_ = popen(filename.substr(1).c_str(), "w");
+    } else {
+        path_ = filename;
+        file_ = std::fopen(filename.c_str(), "wb");
+    }
+    if (file_ == nullptr) {
+        throw std::runtime_error("Cannot open video output \"" + filename + "\"!");
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, fileBufferSize);
+
+    // The destructor does not run if the constructor throws.
+    try {
+        std::string header;
+        if (format_ == Format::Y4M) {
+            header = "YUV4MPEG2 W" + std::to_string(width_) + " H" + std::to_string(height_) + " F" +
+                     std::to_string(fps) + ":1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+            planes_.resize(static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_) * 3);
+        }
+
+        // Reserve the whole file upfront for regular files, so the file system does not need to allocate blocks
+        // every frame. Pipes, FIFOs or devices are streamed as is.
+        if (!isPipe_ && std::filesystem::is_regular_file(path_)) {
+            const uint64_t pixels = static_cast<uint64_t>(width_) * static_cast<uint64_t>(height_);
+            const uint64_t frameSize =
+                (format_ == Format::Y4M) ? sizeof(y4mFrameHeader) - 1 + pixels * 3 : pixels * 4;
+            const uint64_t fileSize = header.size() + numFrames * frameSize;
+            if (preallocate(file_, fileSize)) {
+                bytesPreallocated_ = fileSize;
+            }
+        }
+
+        write(header.data(), header.size());
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+VideoWriter::~VideoWriter() {
+    close();
+}
+
+void VideoWriter::close() {
+    if (isPipe_) {
+        pclose(file_);
+        return;
+    }
+    std::fclose(file_);
+    // Remove unused preallocated space, i.e., when the recording was stopped early.
+    if (bytesPreallocated_ > bytesWritten_) {
+        std::error_code ec;
+        std::filesystem::resize_file(path_, bytesWritten_, ec);
+    }
+}
+
+void VideoWriter::writeFrame(const ImageView& image) {
+    if (image.width != width_ || image.height != height_) {
+        throw std::runtime_error("Video frame size changed during recording!");
+    }
+
+    if (format_ == Format::Raw) {
+        if (image.isPacked() && !image.bottomUp) {
+            write(image.data, image.rowSize() * static_cast<std::size_t>(height_));
+        } else {
+            for (int y = 0; y < height_; y++) {
+                write(image.row(y), image.rowSize());
+            }
+        }
+    } else {
+        const std::size_t planeSize = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+        unsigned char* yPlane = planes_.data();
+        unsigned char* uPlane = yPlane + planeSize;
+        unsigned char* vPlane = uPlane + planeSize;
+        std::size_t i = 0;
+        for (int y = 0; y < height_; y++) {
+            const unsigned char* row = image.row(y);
+            for (int x = 0; x < width_; x++, i++) {
+                // Full range BT.601 in 8 bit fixed point.
+                const int r = row[4 * x];
+                const int g = row[4 * x + 1];
+                const int b = row[4 * x + 2];
+                yPlane[i] = clampToByte((77 * r + 150 * g + 29 * b + 128) >> 8);
+                uPlane[i] = clampToByte(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128);
+                vPlane[i] = clampToByte(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128);
+            }
+        }
+        write(y4mFrameHeader, sizeof(y4mFrameHeader) - 1);
+        write(planes_.data(), planes_.size());
+    }
+    framesWritten_++;
+}
+
+VideoWriter::Format VideoWriter::formatFromFilename(const std::string& filename) {
+    std::string ext = std::filesystem::path(filename).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return (ext == ".y4m") ? Format::Y4M : Format::Raw;
+}
+
+void VideoWriter::write(const void* data, std::size_t size) {
+    if (std::fwrite(data, 1, size, file_) != size) {
+        throw std::runtime_error("Cannot write video output!");
+    }
+    bytesWritten_ += size;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+
+namespace OGL4Core2::Core {
+    /**
+     * Streams a sequence of equally sized frames into a single file without any compression. Frames are written either
+     * as raw RGBA (8 bit per channel, top-down row order) or as YUV4MPEG2 (4:4:4, full range BT.601), which can be
+     * read directly by tools like ffmpeg. Regular files are preallocated for the expected number of frames, if the
+     * platform and file system support it (Linux, Windows). A filename starting with '|' is interpreted as a shell
+     * command and the frames are piped into its stdin.
+     */
+    class VideoWriter {
+    public:
+        enum class Format {
+            Raw,
+            Y4M,
+        };
+
+        VideoWriter(const std::string& filename, Format format, int width, int height, uint64_t numFrames,
+            int fps = 60);
+        ~VideoWriter();
+
+        VideoWriter(const VideoWriter&) = delete;
+        VideoWriter(VideoWriter&&) = delete;
+        VideoWriter& operator=(const VideoWriter&) = delete;
+        VideoWriter& operator=(VideoWriter&&) = delete;
+
+        /**
+         * Append a frame. The rows of the view are written in top-down order.
+         *
+         * @param image
+         */
+        void writeFrame(const ImageView& image);
+
+        [[nodiscard]] inline uint64_t framesWritten() const {
+            return framesWritten_;
+        }
+
+        /**
+         * Select the format based on the file extension, ".y4m" selects YUV4MPEG2, everything else raw RGBA.
+         *
+         * @param filename
+         * @return Format
+         */
+        static Format formatFromFilename(const std::string& filename);
+
+    private:
+        // Close the file or pipe, also called if the constructor fails after opening it.
+        void close();
+        void write(const void* data, std::size_t size);
+
+        std::FILE* file_;
+        bool isPipe_;
+        std::filesystem::path path_;
+        Format format_;
+        int width_;
+        int height_;
+        uint64_t framesWritten_;
+        uint64_t bytesWritten_;
+        uint64_t bytesPreallocated_;
+        std::vector<unsigned char> planes_;
+    };
+} // namespace OGL4Core2::Core
@@ -1,6 +1,8 @@
 #include <cstdint>
 #include <exception>
+#include <filesystem>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -8,15 +10,58 @@
 #include <cxxopts.hpp>
 
 #include "core/Core.h"
+#include "core/util/FileUtil.h"
+#include "core/util/TraceRecorder.h"
+
+static void parseSize(const std::string& size, int& width, int& height) {
+    const auto sep = size.find('x');
+    if (sep == std::string::npos) {
+        throw std::invalid_argument("Size must have format \"WIDTHxHEIGHT\"!");
+    }
+    width = std::stoi(size.substr(0, sep));
+    height = std::stoi(size.substr(sep + 1));
+    if (width < 1 || height < 1) {
+        throw std::invalid_argument("Invalid size \"" + size + "\"!");
+    }
+}
 
 int main(int argc, char* argv[]) {
     cxxopts::Options options("OGL4Core2", "OGL4Core2");
     // clang-format off
     options.add_options()
         ("p,plugin", "Default loaded plugin.", cxxopts::value<std::string>())
+        ("compare", "Plugins rendered side by side with the selected plugin, each in an own column of the window.", cxxopts::value<std::vector<std::string>>())
+        ("no-frame-cache", "Render plugins with frame caching every frame, instead of reusing their last image while it is valid.")
+        ("async-plugins", "Construct plugins on a worker thread with a shared OpenGL context and show a loading overlay meanwhile.")
+        ("plugin-cache", "Number of plugin instances kept suspended when switching plugins, for instant switching back.", cxxopts::value<std::size_t>())
+        ("plugin-cache-budget", "Memory budget of the suspended plugin instances in MiB, as reported by the plugins. Plugins not reporting their memory usage are only limited by --plugin-cache.", cxxopts::value<std::size_t>())
+        ("resource-cache-budget", "Memory budget of the resources (strings, images, textures) shared between plugins in MiB, 0 for no limit. Default 512.", cxxopts::value<std::size_t>())
+        ("texture-cache", "Directory of textures cooked with mipmaps, reused when loading the same PNG again. Defaults to \"OGL4Core2/texture-cache\" in the user cache directory ($XDG_CACHE_HOME, ~/.cache or %LOCALAPPDATA%).", cxxopts::value<std::string>())
+        ("no-texture-cache", "Cook textures on every load, without reading or writing the texture cache directory.")
+        ("texture-upload-budget", "Texture data uploaded per frame by asynchronous texture loading in MiB. Default 16.", cxxopts::value<std::size_t>())
+        ("plugin-dir", "Directory of plugin modules, which are reloaded when they change. Defaults to \"plugins\" next to the executable, if built with OGL4CORE2_PLUGIN_MODULES.", cxxopts::value<std::string>())
         ("s,screenshot", "List of frame numbers for screenshots.", cxxopts::value<std::vector<uint32_t>>())
         ("f,filename", "Base filename for screenshots.", cxxopts::value<std::string>())
-        ("q,quit", "Quit when screenshot list is empty.")
+        ("screenshot-size", "Screenshot size \"WIDTHxHEIGHT\", if it differs from the window size, screenshots are rendered offscreen in tiles.", cxxopts::value<std::string>())
+        ("png-level", "PNG compression level for screenshots, 0 (fastest) to 9 (smallest).", cxxopts::value<int>())
+        ("q,quit", "Quit when screenshot list is empty and recording is finished.")
+        ("r,record", "Record frame range \"start:end\" (inclusive) into a single uncompressed video file.", cxxopts::value<std::string>())
+        ("record-file", "Output of recording, \"*.y4m\" writes YUV4MPEG2, everything else raw RGBA. Use \"|command\" to pipe frames into a command.", cxxopts::value<std::string>())
+        ("record-fps", "Frame rate written to the Y4M header.", cxxopts::value<int>())
+        ("size", "Initial window size \"WIDTHxHEIGHT\".", cxxopts::value<std::string>())
+        ("headless", "Render offscreen without a window (EGL surfaceless, OSMesa or hidden window). Requires --benchmark, --screenshot, --record, --replay-input or --quit and quits when they are finished.")
+        ("benchmark", "Run benchmark with the given number of measured frames (vsync off, fixed time step), write a report and quit.", cxxopts::value<uint32_t>())
+        ("warmup", "Number of frames rendered before the benchmark measurement starts.", cxxopts::value<uint32_t>())
+        ("benchmark-sweep", "Benchmark all plugins whose name matches the regex one after another and print a comparison. Uses 300 frames if --benchmark is not set.", cxxopts::value<std::string>()->implicit_value(".*"))
+        ("benchmark-file", "Benchmark report, \"*.csv\" writes per-frame times, everything else JSON with summary statistics.", cxxopts::value<std::string>())
+        ("trace", "Trace output, \"*.json\" saves the last frames as Chrome trace on exit, everything else streams all events into a compact binary file.", cxxopts::value<std::string>())
+        ("trace-frames", "Number of frames kept in memory for the trace.", cxxopts::value<uint32_t>())
+        ("pacing", "Frame pacing mode: \"vsync\", \"uncapped\", \"cap\" (sleep until --fps-cap) or \"late\" (vsync, but start rendering as late as possible).", cxxopts::value<std::string>())
+        ("fps-cap", "Frame rate limit, implies --pacing cap if no other mode is given.", cxxopts::value<double>())
+        ("on-demand", "Only render frames after input, window resize or a redraw request of the plugin.")
+        ("record-input", "Record all input events into a binary log.", cxxopts::value<std::string>())
+        ("replay-input", "Replay input events of a log recorded with --record-input instead of live input. Use together with --benchmark, --size and --plugin of the recording for identical runs.", cxxopts::value<std::string>())
+        ("trace-convert", "Convert a binary trace file into Chrome trace JSON (same name with \".json\" extension) and exit.", cxxopts::value<std::string>())
         ("h,help", "Show help.");
     // clang-format on
 
@@ -27,15 +72,152 @@ int main(int argc, char* argv[]) {
         if (result.count("plugin")) {
             cfg.defaultPluginName = result["plugin"].as<std::string>();
         }
+#ifdef OGL4CORE2_PLUGIN_MODULES
+        cfg.pluginModuleDir = (OGL4Core2::Core::FileUtil::getFullExeName().parent_path() / "plugins").string();
+#endif
+        if (result.count("compare")) {
+            cfg.comparePluginNames = result["compare"].as<std::vector<std::string>>();
+        }
+        if (result.count("no-frame-cache")) {
+            cfg.frameCaching = !result["no-frame-cache"].as<bool>();
+        }
+        if (result.count("async-plugins")) {
+            cfg.asyncPluginCreation = result["async-plugins"].as<bool>();
+        }
+        if (result.count("plugin-cache")) {
+            cfg.pluginCacheSize = result["plugin-cache"].as<std::size_t>();
+        }
+        if (result.count("resource-cache-budget")) {
+            cfg.resourceCacheBudget = result["resource-cache-budget"].as<std::size_t>() * 1024 * 1024;
+        }
+        if (result.count("texture-cache")) {
+            cfg.textureCacheDir = result["texture-cache"].as<std::string>();
+        }
+        if (result.count("no-texture-cache")) {
+            cfg.textureCacheDir.clear();
+        }
+        if (result.count("texture-upload-budget")) {
+            cfg.textureUploadBudget = result["texture-upload-budget"].as<std::size_t>() * 1024 * 1024;
+        }
+        if (result.count("plugin-cache-budget")) {
+            cfg.pluginCacheBudget = result["plugin-cache-budget"].as<std::size_t>() * 1024 * 1024;
+        }
+        if (result.count("plugin-dir")) {
+            cfg.pluginModuleDir = result["plugin-dir"].as<std::string>();
+        }
         if (result.count("screenshot")) {
             cfg.screenshotFrames = result["screenshot"].as<std::vector<uint32_t>>();
         }
         if (result.count("filename")) {
             cfg.screenshotFilename = result["filename"].as<std::string>();
         }
+        if (result.count("screenshot-size")) {
+            parseSize(result["screenshot-size"].as<std::string>(), cfg.screenshotWidth, cfg.screenshotHeight);
+        }
+        if (result.count("png-level")) {
+            cfg.pngCompressionLevel = result["png-level"].as<int>();
+            if (cfg.pngCompressionLevel < 0 || cfg.pngCompressionLevel > 9) {
+                throw std::invalid_argument("PNG compression level must be in range [0, 9]!");
+            }
+        }
         if (result.count("quit")) {
             cfg.autoQuit = result["quit"].as<bool>();
         }
+        if (result.count("record")) {
+            const auto range = result["record"].as<std::string>();
+            const auto sep = range.find(':');
+            if (sep == std::string::npos) {
+                throw std::invalid_argument("Record range must have format \"start:end\"!");
+            }
+            cfg.recordFirstFrame = static_cast<uint32_t>(std::stoul(range.substr(0, sep)));
+            cfg.recordLastFrame = static_cast<uint32_t>(std::stoul(range.substr(sep + 1)));
+            if (cfg.recordFirstFrame < 1 || cfg.recordLastFrame < cfg.recordFirstFrame) {
+                throw std::invalid_argument("Invalid record range!");
+            }
+        }
+        if (result.count("record-file")) {
+            cfg.recordFilename = result["record-file"].as<std::string>();
+        }
+        if (result.count("record-fps")) {
+            cfg.recordFps = result["record-fps"].as<int>();
+        }
+        if (result.count("size")) {
+            parseSize(result["size"].as<std::string>(), cfg.windowWidth, cfg.windowHeight);
+        }
+        if (result.count("headless")) {
+            cfg.headless = result["headless"].as<bool>();
+        }
+        if (result.count("benchmark")) {
+            cfg.benchmarkFrames = result["benchmark"].as<uint32_t>();
+            if (cfg.benchmarkFrames < 1) {
+                throw std::invalid_argument("Number of benchmark frames must be greater than zero!");
+            }
+        }
+        if (result.count("warmup")) {
+            cfg.benchmarkWarmupFrames = result["warmup"].as<uint32_t>();
+        }
+        if (result.count("benchmark-sweep")) {
+            cfg.benchmarkSweep = true;
+            cfg.benchmarkSweepFilter = result["benchmark-sweep"].as<std::string>();
+            if (cfg.benchmarkFrames == 0) {
+                cfg.benchmarkFrames = 300;
+            }
+        }
+        if (result.count("benchmark-file")) {
+            cfg.benchmarkFilename = result["benchmark-file"].as<std::string>();
+        }
+        if (result.count("fps-cap")) {
+            cfg.fpsCap = result["fps-cap"].as<double>();
+            if (!(cfg.fpsCap > 0.0)) {
+                throw std::invalid_argument("FPS cap must be greater than zero!");
+            }
+            cfg.pacingMode = OGL4Core2::Core::FramePacer::Mode::Capped;
+        }
+        if (result.count("on-demand")) {
+            cfg.onDemandRendering = result["on-demand"].as<bool>();
+        }
+        if (result.count("record-input")) {
+            cfg.inputRecordFilename = result["record-input"].as<std::string>();
+        }
+        if (result.count("replay-input")) {
+            cfg.inputReplayFilename = result["replay-input"].as<std::string>();
+            if (!cfg.inputRecordFilename.empty()) {
+                throw std::invalid_argument("Input cannot be recorded and replayed at the same time!");
+            }
+        }
+        if (result.count("pacing")) {
+            const auto pacing = result["pacing"].as<std::string>();
+            using Mode = OGL4Core2::Core::FramePacer::Mode;
+            if (pacing == "vsync") {
+                cfg.pacingMode = Mode::VSync;
+            } else if (pacing == "uncapped") {
+                cfg.pacingMode = Mode::Uncapped;
+            } else if (pacing == "cap") {
+                cfg.pacingMode = Mode::Capped;
+            } else if (pacing == "late") {
+                cfg.pacingMode = Mode::RenderLate;
+            } else {
+                throw std::invalid_argument("Invalid pacing mode \"" + pacing + "\"!");
+            }
+        }
+        if (result.count("trace")) {
+            cfg.traceFilename = result["trace"].as<std::string>();
+        }
+        if (result.count("trace-frames")) {
+            cfg.traceFrames = result["trace-frames"].as<uint32_t>();
+            if (cfg.traceFrames < 1) {
+                throw std::invalid_argument("Number of trace frames must be greater than zero!");
+            }
+        }
+        if (cfg.headless) {
+            // Without a window there is no way to close the application, so it must have a task to finish.
+            if (!cfg.autoQuit && cfg.benchmarkFrames == 0 && cfg.screenshotFrames.empty() && cfg.recordLastFrame == 0 &&
+                cfg.inputReplayFilename.empty()) {
+                throw std::invalid_argument(
+                    "Headless mode requires --benchmark, --screenshot, --record, --replay-input or --quit!");
+            }
+            cfg.autoQuit = true;
+        }
     } catch (const std::exception& ex) {
         std::cerr << "Error parsing options: " << ex.what() << std::endl;
         std::cerr << options.help() << std::endl;
@@ -47,6 +229,21 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    if (result.count("trace-convert")) {
+        const std::filesystem::path filename = result["trace-convert"].as<std::string>();
+        try {
+            if (filename.extension() == ".json") {
+                throw std::invalid_argument("Input must be a binary trace file!");
+            }
+            OGL4Core2::Core::TraceRecorder::convertBinaryToJson(filename,
+                std::filesystem::path(filename).replace_extension(".json"));
+        } catch (const std::exception& ex) {
+            std::cerr << "Trace conversion failed: " << ex.what() << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+
     try {
         OGL4Core2::Core::Core c(std::move(cfg));
         c.run();
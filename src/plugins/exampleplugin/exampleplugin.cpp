@@ -1,15 +1,100 @@
 #include "exampleplugin.h"
 
-#include <glad/gl.h>
+#include <stdexcept>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 
+#include "core/Core.h"
+
 using namespace OGL4Core2::Plugins::ExamplePlugin;
 
+namespace {
+    // The triangle is generated from gl_VertexID, so no vertex buffer is needed.
+    constexpr char vertexShaderSource[] = R"(#version 450
+uniform mat4 projMx;
+out vec3 color;
+void main() {
+    const vec2 positions[3] = vec2[3](vec2(-0.8, -0.6), vec2(0.8, -0.6), vec2(0.0, 0.8));
+    const vec3 colors[3] = vec3[3](vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, 1.0));
+    color = colors[gl_VertexID];
+    gl_Position = projMx * vec4(positions[gl_VertexID], 0.0, 1.0);
+}
+)";
+    constexpr char fragmentShaderSource[] = R"(#version 450
+in vec3 color;
+out vec4 fragColor;
+void main() {
+    fragColor = vec4(color, 1.0);
+}
+)";
+
+    GLuint compileShader(GLenum type, const char* source) {
+        const GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE) {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            glDeleteShader(shader);
+            throw std::runtime_error(std::string("Cannot compile shader: ") + log);
+        }
+        return shader;
+    }
+} // namespace
+
+ExamplePlugin::ExamplePlugin(const Core::Core& c) : Core::RenderPlugin(c), program_(0), vao_(0) {
+    // The projection below applies the tile, so high-resolution screenshots are rendered at tile size.
+    setTiledRendering(true);
+
+    // Shader programs are shared between contexts, so they can be created in the constructor.
+    const GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+    const GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertexShader);
+    glAttachShader(program_, fragmentShader);
+    glLinkProgram(program_);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    GLint status = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        glDeleteProgram(program_);
+        throw std::runtime_error("Cannot link shader program!");
+    }
+}
+
+ExamplePlugin::~ExamplePlugin() {
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteProgram(program_);
+}
+
+void ExamplePlugin::initGL() {
+    // Vertex array objects are not shared between contexts, they must be created on the main thread.
+    glCreateVertexArrays(1, &vao_);
+}
+
 void ExamplePlugin::render() {
     if (ImGui::CollapsingHeader("ExamplePlugin", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::Text("Gray screen.");
+        ImGui::Text("Colored triangle on a gray screen.");
     }
 
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
+
+    // The aspect ratio is based on the full image, the tile projection selects the part of the current tile.
+    const auto& tile = core_.getTile();
+    const float aspect = static_cast<float>(tile.fullWidth) / static_cast<float>(tile.fullHeight);
+    const glm::mat4 projMx = core_.getTileProjection() * glm::ortho(-aspect, aspect, -1.0f, 1.0f);
+
+    glUseProgram(program_);
+    glProgramUniformMatrix4fv(program_, glGetUniformLocation(program_, "projMx"), 1, GL_FALSE,
+        glm::value_ptr(projMx));
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glUseProgram(0);
 }
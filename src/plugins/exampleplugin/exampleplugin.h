@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include <glad/gl.h>
+
 #include "core/PluginRegister.h"
 #include "core/RenderPlugin.h"
 
@@ -10,12 +12,18 @@ namespace OGL4Core2::Plugins::ExamplePlugin {
         REGISTERPLUGIN(ExamplePlugin, 10) // NOLINT
 
     public:
-        using Core::RenderPlugin::RenderPlugin;
+        explicit ExamplePlugin(const Core::Core& c);
+        ~ExamplePlugin() override;
 
         static std::string name() {
             return "ExamplePlugin";
         }
 
+        void initGL() override;
         void render() override;
+
+    private:
+        GLuint program_;
+        GLuint vao_;
     };
 } // namespace OGL4Core2::Plugins::ExamplePlugin